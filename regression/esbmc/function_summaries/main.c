@@ -0,0 +1,17 @@
+int nondet_int();
+
+int max(int a, int b)
+{
+  int r = b;
+  if(a > b)
+    r = a;
+  return r;
+}
+
+int main()
+{
+  int x = nondet_int(), y = nondet_int(), z = nondet_int();
+  int m = max(max(x, y), z);
+  __ESBMC_assert(m >= x && m >= y && m >= z, "m is the maximum");
+  return 0;
+}
@@ -0,0 +1,17 @@
+int nondet_int();
+
+int main()
+{
+  int a[8];
+  int i, sum = 0;
+
+  for(i = 0; i < 8; i++)
+    a[i] = nondet_int() % 4;
+
+  for(i = 0; i < 8; i++)
+    sum += a[i] + a[i];
+
+  assert(sum % 2 == 0);
+  assert(sum < 40);
+  return 0;
+}
@@ -0,0 +1,31 @@
+#include <assert.h>
+#include <stdlib.h>
+
+int g[4];
+
+int main()
+{
+  int local = 1;
+  int *a = malloc(sizeof(int) * 2);
+  int *b = malloc(sizeof(int) * 2);
+  char *s = "abc";
+
+  if(a == NULL || b == NULL)
+    return 0;
+
+  a[0] = 10;
+  a[1] = 11;
+  b[0] = 20;
+  b[1] = 21;
+  g[3] = 30;
+
+  assert(a != b);
+  assert((void *)a != (void *)&local);
+  assert((void *)b != (void *)g);
+  assert((void *)s != (void *)a);
+  assert(a[1] == 11 && b[0] == 20 && g[3] == 30 && local == 1);
+
+  free(a);
+  free(b);
+  return 0;
+}
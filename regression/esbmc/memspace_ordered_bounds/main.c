@@ -0,0 +1,18 @@
+#include <stdlib.h>
+
+int main()
+{
+  int *a = malloc(sizeof(int) * 2);
+  int *b = malloc(sizeof(int) * 2);
+
+  if(a == NULL || b == NULL)
+    return 0;
+
+  // Objects are laid out one after the other, but that doesn't make walking
+  // off the end of one into the next valid
+  a[2] = 1;
+
+  free(a);
+  free(b);
+  return 0;
+}
@@ -0,0 +1,13 @@
+int nondet_int();
+
+int main()
+{
+  int a[4];
+  int *p = a;
+  int i = nondet_int();
+  __ESBMC_assume(i >= 0 && i < 4);
+
+  p[i] = 1;
+  assert(a[i] == 1);
+  return 0;
+}
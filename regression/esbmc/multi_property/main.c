@@ -0,0 +1,14 @@
+#include <assert.h>
+
+int nondet_int();
+
+int main()
+{
+  int x = nondet_int();
+  int y = nondet_int();
+
+  assert(x != 1);
+  assert(x != 1 || y != 1 || x == y);
+  assert(y != 2);
+  return 0;
+}
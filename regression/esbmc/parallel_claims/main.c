@@ -0,0 +1,19 @@
+#include <assert.h>
+
+int nondet_int();
+
+int main()
+{
+  int x = nondet_int();
+  int y = nondet_int();
+  int z = 0;
+
+  for(int i = 0; i < 4; i++)
+    z += i;
+
+  // Each claim only depends on one of x, y and z
+  assert(x != 1);
+  assert(z == 6);
+  assert(y != 2);
+  return 0;
+}
@@ -0,0 +1,11 @@
+#include "counter.h"
+
+void counter_add(struct counter *c, int n)
+{
+  c->value += n;
+}
+
+int counter_get(const struct counter *c)
+{
+  return c->value;
+}
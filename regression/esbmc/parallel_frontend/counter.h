@@ -0,0 +1,7 @@
+struct counter
+{
+  int value;
+};
+
+void counter_add(struct counter *c, int n);
+int counter_get(const struct counter *c);
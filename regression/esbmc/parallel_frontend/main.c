@@ -0,0 +1,16 @@
+#include "counter.h"
+
+int nondet_int();
+
+int main()
+{
+  struct counter c = {0};
+  int n = nondet_int();
+  __ESBMC_assume(n > 0 && n < 10);
+
+  counter_add(&c, n);
+  counter_add(&c, n);
+  assert(counter_get(&c) == 2 * n);
+  assert(counter_get(&c) != 10);
+  return 0;
+}
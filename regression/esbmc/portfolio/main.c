@@ -0,0 +1,11 @@
+unsigned int nondet_uint();
+
+int main()
+{
+  unsigned int a[4];
+  unsigned int i = nondet_uint();
+  __ESBMC_assume(i < 4);
+  a[i] = i * 3;
+  assert(a[i] != 6);
+  return 0;
+}
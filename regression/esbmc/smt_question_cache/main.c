@@ -0,0 +1,16 @@
+int nondet_int();
+
+int main()
+{
+  int x = nondet_int();
+  int y = 0;
+  __ESBMC_assume(x > 0);
+
+  if(x > 0)
+    y = 1;
+  if(x > 0)
+    y = y + 1;
+
+  assert(y == 2);
+  return 0;
+}
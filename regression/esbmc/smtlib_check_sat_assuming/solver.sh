@@ -0,0 +1,32 @@
+#!/bin/sh
+# Passes ESBMC's queries on to z3, checking that claims are only ever
+# checked under assumptions, in the one solver process: a plain check-sat
+# is answered with an error, and so is assuming anything other than Bool
+# literals declared beforehand.
+exec 3>&1
+declared=" "
+while IFS= read -r line; do
+  case "$line" in
+  "(declare-fun "*" () Bool)")
+    name=${line#"(declare-fun "}
+    declared="$declared${name%" () Bool)"} "
+    ;;
+  "(check-sat-assuming ("*"))")
+    lits=${line#"(check-sat-assuming ("}
+    for lit in ${lits%"))"}; do
+      case "$declared" in
+      *" $lit "*) ;;
+      *)
+        echo "(error \"$lit is not a declared Bool literal\")" >&3
+        continue 2
+        ;;
+      esac
+    done
+    ;;
+  "(check-sat)")
+    echo '(error "expected check-sat-assuming")' >&3
+    continue
+    ;;
+  esac
+  printf '%s\n' "$line"
+done | z3 -in -smt2
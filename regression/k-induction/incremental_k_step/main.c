@@ -0,0 +1,13 @@
+#include <assert.h>
+
+int nondet_int();
+
+int main()
+{
+  int i, sn = 0;
+  int n = nondet_int();
+  __ESBMC_assume(n > 0 && n < 8);
+  for(i = 0; i < n; i++)
+    sn = sn + 2;
+  assert(sn == n * 2);
+}
@@ -8,6 +8,7 @@ import unittest
 from subprocess import Popen, PIPE
 import argparse
 import re
+import tempfile
 import xml.etree.ElementTree as ET
 
 #####################
@@ -70,6 +71,13 @@ class BaseTest:
         self.test_args = None
         self.test_file = None
         self.test_mode = "CORE"
+        # Some tests (e.g. of caches) need the tool run more than once; only
+        # the output of the last run is checked
+        self.test_runs = 1
+        runs_path = os.path.join(test_dir, "runs")
+        if os.path.exists(runs_path):
+            with open(runs_path) as fp:
+                self.test_runs = int(fp.readline().strip())
         self._initialize_test_case()
 
 
@@ -199,9 +207,16 @@ class Executor:
 
     def run(self, test_case: BaseTest):
         """Execute the test case with `executable`"""
-        process = Popen(test_case.generate_run_argument_list(self.tool), stdout=PIPE, stderr=PIPE,
-                        cwd=test_case.test_dir)
-        stdout, stderr = process.communicate()
+        # @TMPDIR@ in the arguments stands for a directory that is fresh for
+        # each test, and removed after it, so that caches and other output
+        # stay out of the source tree
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            args = [x.replace("@TMPDIR@", tmp_dir)
+                    for x in test_case.generate_run_argument_list(self.tool)]
+            for _ in range(test_case.test_runs):
+                process = Popen(args, stdout=PIPE, stderr=PIPE,
+                                cwd=test_case.test_dir)
+                stdout, stderr = process.communicate()
         return stdout, stderr
 
 
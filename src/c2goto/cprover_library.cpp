@@ -6,21 +6,10 @@ Author: Daniel Kroening, kroening@kroening.com
 
 \*******************************************************************/
 
-extern "C"
-{
-#include <unistd.h>
-
-#ifdef _WIN32
-#include <windows.h>
-#include <io.h>
-#undef small // MinGW header workaround
-#endif
-}
-
 #include <c2goto/cprover_library.h>
 #include <cstdlib>
-#include <fstream>
-#include <goto-programs/read_goto_binary.h>
+#include <goto-programs/goto_binary_index.h>
+#include <map>
 #include <util/c_link.h>
 #include <util/config.h>
 
@@ -49,90 +38,6 @@ extern "C"
 #undef p
 #endif
 
-bool is_in_list(std::list<irep_idt> &list, irep_idt item)
-{
-  for(std::list<irep_idt>::const_iterator it = list.begin(); it != list.end();
-      it++)
-    if(*it == item)
-      return true;
-
-  return false;
-}
-
-void generate_symbol_deps(
-  irep_idt name,
-  irept irep,
-  std::multimap<irep_idt, irep_idt> &deps)
-{
-  std::pair<irep_idt, irep_idt> type;
-
-  if(irep.id() == "symbol")
-  {
-    type = std::pair<irep_idt, irep_idt>(name, irep.identifier());
-    deps.insert(type);
-    return;
-  }
-
-  forall_irep(irep_it, irep.get_sub())
-  {
-    if(irep_it->id() == "symbol")
-    {
-      type = std::pair<irep_idt, irep_idt>(name, irep_it->identifier());
-      deps.insert(type);
-      generate_symbol_deps(name, *irep_it, deps);
-    }
-    else if(irep_it->id() == "argument")
-    {
-      type = std::pair<irep_idt, irep_idt>(name, irep_it->cmt_identifier());
-      deps.insert(type);
-    }
-    else
-    {
-      generate_symbol_deps(name, *irep_it, deps);
-    }
-  }
-
-  forall_named_irep(irep_it, irep.get_named_sub())
-  {
-    if(irep_it->second.id() == "symbol")
-    {
-      type = std::pair<irep_idt, irep_idt>(name, irep_it->second.identifier());
-      deps.insert(type);
-    }
-    else if(irep_it->second.id() == "argument")
-    {
-      type =
-        std::pair<irep_idt, irep_idt>(name, irep_it->second.cmt_identifier());
-      deps.insert(type);
-    }
-    else
-    {
-      generate_symbol_deps(name, irep_it->second, deps);
-    }
-  }
-}
-
-void ingest_symbol(
-  irep_idt name,
-  std::multimap<irep_idt, irep_idt> &deps,
-  std::list<irep_idt> &to_include)
-{
-  std::pair<
-    std::multimap<irep_idt, irep_idt>::const_iterator,
-    std::multimap<irep_idt, irep_idt>::const_iterator>
-    range;
-  std::multimap<irep_idt, irep_idt>::const_iterator it;
-
-  range = deps.equal_range(name);
-  if(range.first == range.second)
-    return;
-
-  for(it = range.first; it != range.second; it++)
-    to_include.push_back(it->second);
-
-  deps.erase(name);
-}
-
 #ifdef NO_CPROVER_LIBRARY
 void add_cprover_library(contextt &, message_handlert &)
 {
@@ -145,15 +50,10 @@ void add_cprover_library(contextt &context, message_handlert &message_handler)
   if(config.ansi_c.lib == configt::ansi_ct::libt::LIB_NONE)
     return;
 
-  contextt new_ctx, store_ctx;
-  goto_functionst goto_functions;
-  std::multimap<irep_idt, irep_idt> symbol_deps;
-  std::list<irep_idt> to_include;
-  char symname_buffer[288];
-  FILE *f;
+  contextt store_ctx;
+  goto_binary_indext library;
   uint8_t **this_clib_ptrs;
   uint64_t size;
-  int fd;
 
   if(config.ansi_c.word_size == 32)
   {
@@ -198,76 +98,59 @@ void add_cprover_library(contextt &context, message_handlert &message_handler)
     abort();
   }
 
-#ifndef _WIN32
-  sprintf(symname_buffer, "/tmp/ESBMC_XXXXXX");
-  fd = mkstemp(symname_buffer);
-  close(fd);
-#else
-  char tmpdir[256];
-  GetTempPath(sizeof(tmpdir), tmpdir);
-  GetTempFileName(tmpdir, "bmc", 0, symname_buffer);
-#endif
-  f = fopen(symname_buffer, "wb");
-  if(fwrite(this_clib_ptrs[0], size, 1, f) != 1)
+  // The library is read in place, and only the symbols the program uses, plus
+  // those they use in turn, are decoded
+  if(library.parse((const char *)this_clib_ptrs[0], size))
   {
-    std::cerr << "Couldn't manipulate internal C library" << std::endl;
+    std::cerr << "error: Malformed internal C library" << std::endl;
     abort();
   }
-  fclose(f);
 
-  std::ifstream infile(symname_buffer, std::ios::in | std::ios::binary);
-  read_goto_binary(infile, new_ctx, goto_functions, message_handler);
-  infile.close();
-#ifndef _WIN32
-  unlink(symname_buffer);
-#else
-  DeleteFile(symname_buffer);
-#endif
+  std::vector<bool> wanted(library.symbols.size(), false);
+  std::vector<unsigned> to_include;
+
+  auto want = [&wanted, &to_include](int nr) {
+    if(nr < 0 || wanted[nr])
+      return;
+    wanted[nr] = true;
+    to_include.push_back(nr);
+  };
 
-  new_ctx.foreach_operand([&symbol_deps](const symbolt &s) {
-    generate_symbol_deps(s.id, s.value, symbol_deps);
-    generate_symbol_deps(s.id, s.type, symbol_deps);
-  });
+  for(unsigned nr = 0; nr < library.symbols.size(); nr++)
+  {
+    const symbolt *symbol = context.find_symbol(library.symbols[nr].name);
+    if(symbol != nullptr && symbol->value.is_nil())
+      want(nr);
+  }
 
   // Add two hacks; we migth use either pthread_mutex_lock or the checked
   // variety; so if one version is used, pull in the other too.
-  std::pair<irep_idt, irep_idt> lockcheck(
-    dstring("pthread_mutex_lock"), dstring("pthread_mutex_lock_check"));
-  symbol_deps.insert(lockcheck);
+  std::multimap<irep_idt, irep_idt> extra_deps = {
+    {"pthread_mutex_lock", "pthread_mutex_lock_check"},
+    {"pthread_cond_wait", "pthread_cond_wait_check"},
+    {"pthread_join", "pthread_join_noswitch"}};
 
-  std::pair<irep_idt, irep_idt> condcheck(
-    dstring("pthread_cond_wait"), dstring("pthread_cond_wait_check"));
-  symbol_deps.insert(condcheck);
+  /* The code pulled in might use other symbols in the C library. So, follow
+   * the index to pull in everything they refer to. */
 
-  std::pair<irep_idt, irep_idt> joincheck(
-    dstring("pthread_join"), dstring("pthread_join_noswitch"));
-  symbol_deps.insert(joincheck);
+  for(unsigned i = 0; i < to_include.size(); i++)
+  {
+    const goto_binary_indext::symbol_entryt &entry =
+      library.symbols[to_include[i]];
 
-  /* The code just pulled into store_ctx might use other symbols in the C
-   * library. So, repeatedly search for new C library symbols that we use but
-   * haven't pulled in, then pull them in. We finish when we've made a pass
-   * that adds no new symbols. */
+    for(unsigned dep : entry.deps)
+      want(dep);
 
-  new_ctx.foreach_operand(
-    [&context, &store_ctx, &symbol_deps, &to_include](const symbolt &s) {
-      const symbolt *symbol = context.find_symbol(s.id);
-      if(symbol != nullptr && symbol->value.is_nil())
-      {
-        store_ctx.add(s);
-        ingest_symbol(s.id, symbol_deps, to_include);
-      }
-    });
+    auto range = extra_deps.equal_range(entry.name);
+    for(auto it = range.first; it != range.second; it++)
+      want(library.find_symbol(it->second));
+  }
 
-  for(std::list<irep_idt>::const_iterator nameit = to_include.begin();
-      nameit != to_include.end();
-      nameit++)
+  for(unsigned nr : to_include)
   {
-    symbolt *s = new_ctx.find_symbol(*nameit);
-    if(s != nullptr)
-    {
-      store_ctx.add(*s);
-      ingest_symbol(*nameit, symbol_deps, to_include);
-    }
+    symbolt s;
+    library.read_symbol(nr, s);
+    store_ctx.add(s);
   }
 
   if(c_link(context, store_ctx, message_handler, "<built-in-library>"))
@@ -20,6 +20,28 @@
 #include <clang-c-frontend/AST/build_ast.h>
 #include <clang-c-frontend/AST/esbmc_action.h>
 
+namespace
+{
+/** Writes the precompiled header to a given file, rather than wherever the
+ *  compiler arguments would put it */
+class esbmc_pch_action : public clang::GeneratePCHAction
+{
+public:
+  explicit esbmc_pch_action(const std::string &_output) : output(_output)
+  {
+  }
+
+protected:
+  bool BeginInvocation(clang::CompilerInstance &CI) override
+  {
+    CI.getFrontendOpts().OutputFile = output;
+    return true;
+  }
+
+  std::string output;
+};
+} // namespace
+
 std::unique_ptr<clang::ASTUnit> buildASTs(
   const std::string &intrinsics,
   const std::vector<std::string> &compiler_args)
@@ -114,3 +136,28 @@ std::unique_ptr<clang::ASTUnit> buildASTs(
 
   return unit;
 }
+
+bool buildPCH(
+  const std::string &header,
+  const std::vector<std::string> &compiler_args,
+  const std::string &output)
+{
+  std::vector<std::string> args(compiler_args);
+  args.emplace_back("-x");
+  args.emplace_back("c-header");
+  args.push_back(header);
+
+  // The header is read from disk, so that the PCH can check it when loaded
+  llvm::IntrusiveRefCntPtr<clang::FileManager> Files(
+    new clang::FileManager(clang::FileSystemOptions()));
+
+#if(CLANG_VERSION_MAJOR >= 10)
+  clang::tooling::ToolInvocation Invocation(
+    std::move(args), std::make_unique<esbmc_pch_action>(output), Files.get());
+#else
+  clang::tooling::ToolInvocation Invocation(
+    std::move(args), new esbmc_pch_action(output), Files.get());
+#endif
+
+  return !Invocation.run();
+}
@@ -2,6 +2,7 @@
 #define CLANG_C_FRONTEND_AST_BUILD_AST_H_
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -18,4 +19,10 @@ std::unique_ptr<clang::ASTUnit> buildASTs(
   const std::string &intrinsics,
   const std::vector<std::string> &compiler_args);
 
+// Precompile a C header into output; true on error
+bool buildPCH(
+  const std::string &header,
+  const std::vector<std::string> &compiler_args,
+  const std::string &output);
+
 #endif /* CLANG_C_FRONTEND_AST_BUILD_AST_H_ */
@@ -9,10 +9,12 @@ Author: Daniel Kroening, kroening@cs.cmu.edu
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wstrict-aliasing"
 #pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <clang/Basic/Version.inc>
 #include <clang/Frontend/ASTUnit.h>
 #pragma GCC diagnostic pop
 
 #include <AST/build_ast.h>
+#include <ac_config.h>
 #include <ansi-c/c_preprocess.h>
 #include <boost/filesystem.hpp>
 #include <c2goto/cprover_library.h>
@@ -21,8 +23,15 @@ Author: Daniel Kroening, kroening@cs.cmu.edu
 #include <clang-c-frontend/clang_c_language.h>
 #include <clang-c-frontend/clang_c_main.h>
 #include <clang-c-frontend/expr2c.h>
+#include <fstream>
+#include <map>
 #include <sstream>
+#include <unistd.h>
 #include <util/c_link.h>
+#include <util/crypto_hash.h>
+#include <util/message.h>
+#include <util/phase_stats.h>
+#include <util/time_stopping.h>
 
 languaget *new_clang_c_language()
 {
@@ -40,15 +49,21 @@ clang_c_languaget::clang_c_languaget()
     abort();
   }
 
-  // Create temporary directory
-  p += "/esbmc_clang_headers";
-  boost::filesystem::create_directory(p);
-  if(!boost::filesystem::is_directory(p))
+  // Create temporary directory, or name one in the frontend cache, where
+  // later runs of the same build will find the headers already dumped
+  const std::string &cache = config.options.get_option("frontend-cache");
+  if(cache != "")
   {
-    std::cerr
-      << "Can't create temporary directory (needed to dump clang headers)"
-      << std::endl;
-    abort();
+    p = cache;
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(p, ec);
+    p /= "clang-headers-" CLANG_VERSION_STRING "-" ESBMC_VERSION "-" +
+         clang_headers_id();
+  }
+  else
+  {
+    p += "/esbmc_clang_headers";
+    boost::filesystem::create_directory(p);
   }
 
   // Build the compile arguments
@@ -56,6 +71,14 @@ clang_c_languaget::clang_c_languaget()
 
   // Dump clang headers on the temporary folder
   dump_clang_headers(p.string());
+
+  if(!boost::filesystem::is_directory(p))
+  {
+    std::cerr
+      << "Can't create temporary directory (needed to dump clang headers)"
+      << std::endl;
+    abort();
+  }
 }
 
 void clang_c_languaget::build_compiler_args(const std::string &&tmp_dir)
@@ -193,15 +216,25 @@ bool clang_c_languaget::parse(
   if(preprocess(path, o_preprocessed, message_handler))
     return true;
 
+  // The intrinsics can come precompiled; only C headers are, so far
+  std::string pch;
+  if(config.options.get_option("frontend-cache") != "" && id() == "c")
+    pch = intrinsics_pch(message_handler);
+
   // Force the file type, .c for the C frontend and .cpp for the C++ one
   force_file_type();
 
   // Get compiler arguments and add the file path
   std::vector<std::string> new_compiler_args(compiler_args);
+  if(!pch.empty())
+  {
+    new_compiler_args.emplace_back("-include-pch");
+    new_compiler_args.push_back(pch);
+  }
   new_compiler_args.push_back(path);
 
-  // Get intrinsics
-  std::string intrinsics = internal_additions();
+  // Get intrinsics, unless they're in the PCH
+  std::string intrinsics = pch.empty() ? internal_additions() : "";
 
   // Generate ASTUnit and add to our vector
   auto AST = buildASTs(intrinsics, new_compiler_args);
@@ -216,6 +249,90 @@ bool clang_c_languaget::parse(
   return false;
 }
 
+static void ingest_string(crypto_hash &hash, const std::string &str)
+{
+  uint32_t len = str.size();
+  hash.ingest(&len, sizeof(len));
+  hash.ingest(str.data(), str.size());
+}
+
+std::string clang_c_languaget::intrinsics_pch(message_handlert &message_handler)
+{
+  const std::string &dir = config.options.get_option("frontend-cache");
+  std::string intrinsics = internal_additions();
+
+  // A PCH only loads into the clang that built it, with the same options
+  crypto_hash hash;
+  ingest_string(hash, ESBMC_VERSION);
+  ingest_string(hash, CLANG_VERSION_STRING);
+  for(auto const &arg : compiler_args)
+    ingest_string(hash, arg);
+  ingest_string(hash, intrinsics);
+  hash.fin();
+
+  std::string base = dir + "/intrinsics-" + hash.to_string();
+  std::string header = base + ".h";
+  std::string pch = base + ".pch";
+
+  // Each process looks for it once
+  static std::map<std::string, std::string> known;
+  auto it = known.find(pch);
+  if(it != known.end())
+    return it->second;
+
+  messaget message(message_handler);
+  std::string &result = known[pch];
+
+  if(boost::filesystem::exists(pch) && boost::filesystem::exists(header))
+  {
+    message.status("Frontend cache: using precompiled intrinsics (warm)");
+    result = pch;
+    return result;
+  }
+
+  phase_timert pch_phase("frontend_cache");
+  fine_timet build_start = current_time();
+  std::string tmp = base + "." + std::to_string(getpid());
+
+  // The PCH checks the header's modification time when loaded, so it is
+  // never replaced once in place; racing processes write the same content.
+  boost::system::error_code ec;
+  if(!boost::filesystem::exists(header))
+  {
+    {
+      std::ofstream out(tmp);
+      out << intrinsics;
+    }
+    boost::filesystem::create_hard_link(tmp, header, ec);
+    boost::filesystem::remove(tmp, ec);
+  }
+
+  if(
+    !boost::filesystem::exists(header) ||
+    buildPCH(header, compiler_args, tmp))
+  {
+    boost::filesystem::remove(tmp, ec);
+    message.warning("Frontend cache: failed to precompile the intrinsics");
+    return result;
+  }
+
+  boost::filesystem::rename(tmp, pch, ec);
+  if(ec)
+  {
+    boost::filesystem::remove(tmp, ec);
+    return result;
+  }
+
+  std::ostringstream str;
+  str << "Frontend cache: precompiled intrinsics in ";
+  output_time(current_time() - build_start, str);
+  str << "s (cold)";
+  message.status(str.str());
+
+  result = pch;
+  return result;
+}
+
 bool clang_c_languaget::typecheck(
   contextt &context,
   const std::string &module,
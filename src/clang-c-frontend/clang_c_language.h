@@ -72,7 +72,15 @@ protected:
   virtual std::string internal_additions();
   virtual void force_file_type();
 
+  // Precompiled intrinsics in the --frontend-cache directory, built on first
+  // use; empty if they can't be had
+  std::string intrinsics_pch(message_handlert &message_handler);
+
+  // Headers in the frontend cache are written to a directory of their own,
+  // moved into place once complete, and never changed afterwards
   void dump_clang_headers(const std::string &tmp_dir);
+  // Identifies the headers this build carries, for the cache directory name
+  static std::string clang_headers_id();
   void build_compiler_args(const std::string &&tmp_dir);
 
   std::vector<std::string> compiler_args;
@@ -1,5 +1,10 @@
+#include <boost/filesystem.hpp>
 #include <clang-c-frontend/clang_c_language.h>
+#include <cstring>
 #include <fstream>
+#include <unistd.h>
+#include <util/config.h>
+#include <util/state_hash.h>
 
 struct hooked_header
 {
@@ -604,11 +609,47 @@ void clang_c_languaget::dump_clang_headers(const std::string &tmp_dir)
     return;
   dumped = true;
 
+  // Headers in the frontend cache were dumped by an earlier run
+  bool cached = config.options.get_option("frontend-cache") != "";
+  if(cached && boost::filesystem::is_directory(tmp_dir))
+    return;
+
+  // Runs sharing the cache never see it half written: the headers go into a
+  // directory of this process's own first, which is then renamed into place
+  boost::system::error_code ec;
+  std::string dir = tmp_dir;
+  if(cached)
+  {
+    dir += "." + std::to_string(getpid());
+    boost::filesystem::create_directory(dir, ec);
+  }
+
   for(struct hooked_header *h = &clang_headers[0]; h->basename != nullptr; h++)
   {
     std::ofstream header;
-    header.open(tmp_dir + "/" + std::string(h->basename));
+    header.open(dir + "/" + std::string(h->basename));
     header << std::string(h->textstart, *h->textsize);
     header.close();
   }
+
+  if(cached)
+  {
+    // If another run got there first, its headers are the same as these
+    boost::filesystem::rename(dir, tmp_dir, ec);
+    if(ec)
+      boost::filesystem::remove_all(dir, ec);
+  }
+}
+
+std::string clang_c_languaget::clang_headers_id()
+{
+  // Hashing the headers themselves tells apart builds of the same version
+  state_hash_buildert hash;
+  for(struct hooked_header *h = &clang_headers[0]; h->basename != nullptr; h++)
+  {
+    hash.bytes(h->basename, strlen(h->basename));
+    hash.bytes(h->textstart, *h->textsize);
+  }
+
+  return hash.finish().to_string();
 }
@@ -11,6 +11,8 @@ Authors: Daniel Kroening, kroening@kroening.com
 #include <sys/types.h>
 
 #ifndef _WIN32
+#include <fcntl.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #else
 #include <windows.h>
@@ -20,6 +22,7 @@ Authors: Daniel Kroening, kroening@kroening.com
 #endif
 
 #include <ac_config.h>
+#include <cerrno>
 #include <esbmc/bmc.h>
 #include <esbmc/document_subgoals.h>
 #include <fstream>
@@ -38,6 +41,7 @@ Authors: Daniel Kroening, kroening@kroening.com
 #include <util/location.h>
 #include <util/message_stream.h>
 #include <util/migrate.h>
+#include <util/phase_stats.h>
 #include <util/show_symbol_table.h>
 #include <util/time_stopping.h>
 
@@ -55,6 +59,12 @@ bmct::bmct(
   interleaving_number = 0;
   interleaving_failed = 0;
 
+  ileave_workers =
+    options.get_bool_option("schedule")
+      ? 0
+      : atoi(options.get_option("parallel-interleavings").c_str());
+  ileave_error = false;
+
   if(options.get_bool_option("smt-during-symex"))
   {
     runtime_solver = std::shared_ptr<smt_convt>(create_solver_factory(
@@ -130,7 +140,8 @@ void bmct::successful_trace()
 
 void bmct::error_trace(
   std::shared_ptr<smt_convt> &smt_conv,
-  std::shared_ptr<symex_target_equationt> &eq)
+  std::shared_ptr<symex_target_equationt> &eq,
+  const symex_target_equationt::SSA_stept *claim)
 {
   if(options.get_bool_option("result-only"))
     return;
@@ -138,7 +149,9 @@ void bmct::error_trace(
   status("Building error trace");
 
   goto_tracet goto_trace;
-  build_goto_trace(eq, smt_conv, goto_trace);
+  phase_timert trace_phase("trace_building");
+  build_goto_trace(eq, smt_conv, goto_trace, claim);
+  trace_phase.stop();
 
   switch(ui)
   {
@@ -188,9 +201,11 @@ smt_convt::resultt bmct::run_decision_procedure(
   smt_conv->set_message_handler(message_handler);
   smt_conv->set_verbosity(get_verbosity());
 
+  phase_timert encode_phase("encoding");
   fine_timet encode_start = current_time();
   do_cbmc(smt_conv, eq);
   fine_timet encode_stop = current_time();
+  encode_phase.stop();
 
   std::ostringstream str;
   str << "Encoding to solver time: ";
@@ -198,6 +213,12 @@ smt_convt::resultt bmct::run_decision_procedure(
   str << "s";
   status(str.str());
 
+  if(phase_statst::enabled)
+    status(eq->encoding_stats_text());
+
+  if(options.get_bool_option("memstats"))
+    status(smt_conv->ast_arena_stats());
+
   if(
     options.get_bool_option("smt-formula-too") ||
     options.get_bool_option("smt-formula-only"))
@@ -211,9 +232,11 @@ smt_convt::resultt bmct::run_decision_procedure(
   ss << "Solving with solver " << smt_conv->solver_text();
   status(ss.str());
 
+  phase_timert solve_phase("solving");
   fine_timet sat_start = current_time();
   smt_convt::resultt dec_result = smt_conv->dec_solve();
   fine_timet sat_stop = current_time();
+  solve_phase.stop();
 
   // output runtime
   str.clear();
@@ -225,6 +248,666 @@ smt_convt::resultt bmct::run_decision_procedure(
   return dec_result;
 }
 
+smt_convt::resultt
+bmct::run_portfolio(std::shared_ptr<symex_target_equationt> &eq)
+{
+#ifdef _WIN32
+  error("Portfolio solving is not supported on Windows, sorry");
+  return smt_convt::P_ERROR;
+#else
+  std::vector<std::string> solvers;
+  std::istringstream list(options.get_option("portfolio"));
+  for(std::string name; std::getline(list, name, ',');)
+  {
+    if(name.empty())
+      continue;
+
+    bool built = false;
+    for(unsigned int i = 0; i < esbmc_num_solvers; i++)
+      built |= (esbmc_solvers[i].name == name);
+
+    // Run whichever of the listed solvers there are
+    if(!built)
+    {
+      warning(
+        "The " + name +
+        " solver has not been built into this version of ESBMC, leaving it "
+        "out of the portfolio");
+      continue;
+    }
+
+    solvers.push_back(name);
+  }
+
+  if(solvers.empty())
+  {
+    error("None of the solvers given to --portfolio have been built");
+    return smt_convt::P_ERROR;
+  }
+
+  // Each solver encodes and solves the equation in its own process, then
+  // sends its result and timings through this pipe. The winner's
+  // counterexample, printed where the model is, goes to a temporary file
+  // that is replayed here.
+  struct portfolio_resultt
+  {
+    unsigned int solver;
+    int result;
+    fine_timet encode_time;
+    fine_timet solve_time;
+  };
+
+  int result_pipe[2];
+  if(pipe(result_pipe))
+  {
+    error("Pipe creation failed, giving up");
+    return smt_convt::P_ERROR;
+  }
+
+  fcntl(result_pipe[0], F_SETFL, fcntl(result_pipe[0], F_GETFL) | O_NONBLOCK);
+
+  std::stringstream ss;
+  ss << "Solving with portfolio";
+  for(auto const &name : solvers)
+    ss << " " << name;
+  status(ss.str());
+
+  std::cout.flush();
+  std::cerr.flush();
+
+  fine_timet portfolio_start = current_time();
+  std::map<pid_t, unsigned int> children;
+  std::vector<FILE *> outputs(solvers.size(), nullptr);
+  for(unsigned int i = 0; i < solvers.size(); i++)
+  {
+    outputs[i] = tmpfile();
+    pid_t pid = outputs[i] ? fork() : -1;
+    if(pid == -1)
+    {
+      error("Fork failed, giving up");
+      for(auto const &child : children)
+        kill(child.first, SIGKILL);
+      while(wait(nullptr) > 0)
+        ;
+      for(FILE *out : outputs)
+        if(out != nullptr)
+          fclose(out);
+      close(result_pipe[0]);
+      close(result_pipe[1]);
+      return smt_convt::P_ERROR;
+    }
+
+    if(pid)
+    {
+      children.emplace(pid, i);
+      continue;
+    }
+
+    // Child process: only the winner's output matters, and only its
+    // counterexample, which the parent replays
+    close(result_pipe[0]);
+    dup2(fileno(outputs[i]), STDOUT_FILENO);
+    int devnull = open("/dev/null", O_WRONLY);
+    dup2(devnull, STDERR_FILENO);
+
+    portfolio_resultt r = {i, smt_convt::P_ERROR, 0, 0};
+    try
+    {
+      std::shared_ptr<smt_convt> smt_conv(create_solver_factory(
+        solvers[i], options.get_bool_option("int-encoding"), ns, options));
+      smt_conv->set_message_handler(message_handler);
+      smt_conv->set_verbosity(get_verbosity());
+
+      fine_timet encode_start = current_time();
+      do_cbmc(smt_conv, eq);
+      fine_timet solve_start = current_time();
+      smt_convt::resultt res = smt_conv->dec_solve();
+      r.encode_time = solve_start - encode_start;
+      r.solve_time = current_time() - solve_start;
+
+      if(res == smt_convt::P_SATISFIABLE)
+      {
+        runtime_solver = smt_conv;
+        if(config.options.get_bool_option("smt-model"))
+          runtime_solver->print_model();
+
+        if(config.options.get_bool_option("bidirectional"))
+          bidirectional_search(runtime_solver, eq);
+
+        report_trace(res, eq);
+      }
+      r.result = res;
+    }
+    catch(...)
+    {
+      r.result = smt_convt::P_ERROR;
+    }
+
+    std::cout.flush();
+    auto const len = write(result_pipe[1], &r, sizeof(r));
+    (void)len;
+    _exit(0);
+  }
+
+  close(result_pipe[1]);
+
+  // Wait for the first definitive answer
+  std::vector<std::string> stats(solvers.size());
+  std::string counterexample;
+  int winner = -1;
+  smt_convt::resultt res = smt_convt::P_ERROR;
+  while(winner == -1 && !children.empty())
+  {
+    int wstatus;
+    pid_t pid = waitpid(-1, &wstatus, 0);
+    if(pid == -1)
+    {
+      if(errno == EINTR)
+        continue;
+      break;
+    }
+
+    fine_timet now = current_time() - portfolio_start;
+    portfolio_resultt r;
+    while(read(result_pipe[0], &r, sizeof(r)) == sizeof(r))
+    {
+      std::ostringstream str;
+      str << solvers[r.solver];
+      if(
+        r.result == smt_convt::P_SATISFIABLE ||
+        r.result == smt_convt::P_UNSATISFIABLE)
+      {
+        str << ": "
+            << (r.result == smt_convt::P_SATISFIABLE ? "SAT" : "UNSAT")
+            << " after ";
+        output_time(now, str);
+        str << "s (encoding ";
+        output_time(r.encode_time, str);
+        str << "s, solving ";
+        output_time(r.solve_time, str);
+        str << "s)";
+
+        if(winner == -1)
+        {
+          winner = r.solver;
+          res = smt_convt::resultt(r.result);
+
+          // The winner finished printing before it sent its result
+          FILE *out = outputs[r.solver];
+          rewind(out);
+          char buf[4096];
+          for(size_t n; (n = fread(buf, 1, sizeof(buf), out)) > 0;)
+            counterexample.append(buf, n);
+        }
+      }
+      else
+      {
+        str << ": failed after ";
+        output_time(now, str);
+        str << "s";
+      }
+      stats[r.solver] = str.str();
+    }
+
+    auto it = children.find(pid);
+    if(it == children.end())
+      continue;
+
+    if(stats[it->second].empty())
+    {
+      std::ostringstream str;
+      str << solvers[it->second] << ": crashed after ";
+      output_time(now, str);
+      str << "s";
+      stats[it->second] = str.str();
+    }
+
+    children.erase(it);
+  }
+
+  // Kill the losers
+  fine_timet portfolio_stop = current_time();
+  for(auto const &child : children)
+  {
+    kill(child.first, SIGKILL);
+
+    std::ostringstream str;
+    str << solvers[child.second] << ": cancelled after ";
+    output_time(portfolio_stop - portfolio_start, str);
+    str << "s";
+    stats[child.second] = str.str();
+  }
+
+  while(wait(nullptr) > 0)
+    ;
+
+  close(result_pipe[0]);
+  for(FILE *out : outputs)
+    fclose(out);
+
+  status("Portfolio results:");
+  for(auto const &stat : stats)
+    status("  " + stat);
+
+  if(winner == -1)
+  {
+    error("No solver in the portfolio gave an answer");
+    return smt_convt::P_ERROR;
+  }
+
+  std::cout << counterexample;
+  std::cout.flush();
+  return res;
+#endif
+}
+
+smt_convt::resultt bmct::run_multi_property(
+  std::shared_ptr<smt_convt> &smt_conv,
+  std::shared_ptr<symex_target_equationt> &eq)
+{
+  smt_conv->set_message_handler(message_handler);
+  smt_conv->set_verbosity(get_verbosity());
+
+  // Encode the program once; the assertions are only asked about below
+  phase_timert encode_phase("encoding");
+  fine_timet encode_start = current_time();
+  eq->convert_steps(*smt_conv);
+  fine_timet encode_stop = current_time();
+  encode_phase.stop();
+
+  {
+    std::ostringstream str;
+    str << "Encoding to solver time: ";
+    output_time(encode_stop - encode_start, str);
+    str << "s";
+    status(str.str());
+
+    if(phase_statst::enabled)
+      status(eq->encoding_stats_text());
+  }
+
+  // A claim is an assertion in the program: every unwinding of it, and every
+  // check symex generated with the same comment, is part of the same claim
+  struct claimt
+  {
+    std::vector<const symex_target_equationt::SSA_stept *> steps;
+    smt_convt::ast_vec violations;
+    bool violated;
+  };
+
+  std::vector<claimt> claims;
+  std::map<std::pair<unsigned, irep_idt>, std::size_t> claim_ids;
+  for(auto const &step : eq->SSA_steps)
+  {
+    if(!step.is_assert() || step.ignore)
+      continue;
+
+    auto id = std::make_pair(step.source.pc->location_number, step.comment);
+    auto it = claim_ids.find(id);
+    if(it == claim_ids.end())
+    {
+      it = claim_ids.emplace(id, claims.size()).first;
+      claims.push_back(claimt{{}, {}, false});
+    }
+
+    claims[it->second].steps.push_back(&step);
+    claims[it->second].violations.push_back(
+      smt_conv->invert_ast(step.cond_ast));
+  }
+
+  std::list<claimt *> remaining;
+  for(auto &claim : claims)
+    remaining.push_back(&claim);
+
+  std::stringstream ss;
+  ss << "Solving " << claims.size() << " claim(s) with solver "
+     << smt_conv->solver_text();
+  status(ss.str());
+
+  unsigned int num_violated = 0;
+  fine_timet sat_start = current_time();
+  while(!remaining.empty())
+  {
+    // Is any claim without a verdict violated? Claims found violated are not
+    // asked about again, everything else is shared between the queries.
+    //
+    // Soundness relies on remaining only ever shrinking, which the check
+    // after reading the model enforces. Backends without native assumptions
+    // fall back to push_ctx/pop_ctx, and some of them (Boolector, CVC4) don't
+    // retract assertions on pop, so every earlier query may stay asserted.
+    // Each query here is a disjunction over a subset of the previous one's
+    // disjuncts, so it implies all of them and the leftovers don't constrain
+    // it. Any other query shape needs a solver whose end_assumptions really
+    // forgets.
+    smt_convt::ast_vec v;
+    for(auto const &claim : remaining)
+      v.insert(v.end(), claim->violations.begin(), claim->violations.end());
+
+    phase_timert solve_phase("solving");
+    smt_convt::resultt res = smt_conv->dec_solve_assuming(
+      {smt_conv->make_n_ary(smt_conv.get(), &smt_convt::mk_or, v)});
+    solve_phase.stop();
+    if(res != smt_convt::P_SATISFIABLE)
+    {
+      smt_conv->end_assumptions();
+      if(res == smt_convt::P_UNSATISFIABLE)
+        break;
+
+      return res;
+    }
+
+    // The model may violate several claims at once
+    std::size_t num_remaining = remaining.size();
+    for(auto it = remaining.begin(); it != remaining.end();)
+    {
+      const symex_target_equationt::SSA_stept *violated = nullptr;
+      for(auto const &step : (*it)->steps)
+      {
+        if(smt_conv->l_get(step->cond_ast).is_false())
+        {
+          violated = step;
+          break;
+        }
+      }
+
+      if(violated == nullptr)
+      {
+        ++it;
+        continue;
+      }
+
+      (*it)->violated = true;
+      ++num_violated;
+      error_trace(smt_conv, eq, violated);
+      it = remaining.erase(it);
+    }
+
+    smt_conv->end_assumptions();
+
+    // The solver says some claim is violated, but the model doesn't tell
+    // which; asking again would only give the same answer
+    if(remaining.size() == num_remaining)
+    {
+      error(
+        "Solver model violates none of the " + std::to_string(num_remaining) +
+        " claim(s) it was asked about");
+      return smt_convt::P_ERROR;
+    }
+  }
+  fine_timet sat_stop = current_time();
+
+  std::ostringstream str;
+  str << "\nRuntime decision procedure: ";
+  output_time(sat_stop - sat_start, str);
+  str << "s";
+  status(str.str());
+
+  str.str("");
+  str << "Claims: " << claims.size() << " checked, " << num_violated
+      << " violated, " << claims.size() - num_violated << " hold";
+  status(str.str());
+
+  return num_violated ? smt_convt::P_SATISFIABLE : smt_convt::P_UNSATISFIABLE;
+}
+
+smt_convt::resultt
+bmct::run_parallel_claims(std::shared_ptr<symex_target_equationt> &eq)
+{
+#ifdef _WIN32
+  error("Parallel claims are not supported on Windows, sorry");
+  return smt_convt::P_ERROR;
+#else
+  unsigned int num_workers =
+    atoi(options.get_option("parallel-claims").c_str());
+  if(num_workers == 0)
+    num_workers = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+
+  // Claims are grouped as in run_multi_property, by step position
+  std::vector<std::vector<unsigned int>> claims;
+  std::vector<const symex_target_equationt::SSA_stept *> claim_steps;
+  std::map<std::pair<unsigned, irep_idt>, std::size_t> claim_ids;
+  unsigned int num = 0;
+  for(auto const &step : eq->SSA_steps)
+  {
+    unsigned int idx = num++;
+    if(!step.is_assert() || step.ignore)
+      continue;
+
+    auto id = std::make_pair(step.source.pc->location_number, step.comment);
+    auto it = claim_ids.find(id);
+    if(it == claim_ids.end())
+    {
+      it = claim_ids.emplace(id, claims.size()).first;
+      claims.emplace_back();
+      claim_steps.push_back(&step);
+    }
+
+    claims[it->second].push_back(idx);
+  }
+
+  fine_timet graph_start = current_time();
+  claim_slicet slicer(
+    *eq, !options.get_bool_option("no-slice") &&
+           options.get_bool_option("slice-assumes"));
+  fine_timet graph_stop = current_time();
+
+  {
+    std::ostringstream str;
+    str << "Solving " << claims.size() << " claim(s) on their own slices, "
+        << num_workers << " at a time (dependencies collected in ";
+    output_time(graph_stop - graph_start, str);
+    str << "s)";
+    status(str.str());
+  }
+
+  // Each claim is sliced, encoded and solved in its own process, which
+  // sends back this record. What it prints goes to a temporary file, read
+  // back when the process is reaped, so that claims are reported in order,
+  // whichever finishes first, with only running claims holding a file.
+  struct claim_resultt
+  {
+    unsigned int claim;
+    int result;
+    unsigned int kept;
+    fine_timet solve_time;
+  };
+
+  int result_pipe[2];
+  if(pipe(result_pipe))
+  {
+    error("Pipe creation failed, giving up");
+    return smt_convt::P_ERROR;
+  }
+
+  fcntl(result_pipe[0], F_SETFL, fcntl(result_pipe[0], F_GETFL) | O_NONBLOCK);
+
+  std::vector<claim_resultt> results(claims.size());
+  std::vector<FILE *> outputs(claims.size(), nullptr);
+  std::vector<std::string> printed(claims.size());
+  std::vector<bool> done(claims.size(), false);
+  std::map<pid_t, unsigned int> running;
+  unsigned int next = 0, reported = 0, num_violated = 0;
+  bool failed = false;
+
+  fine_timet claims_start = current_time();
+  while(reported < claims.size())
+  {
+    while(next < claims.size() && running.size() < num_workers)
+    {
+      unsigned int i = next++;
+      results[i] = claim_resultt{i, smt_convt::P_ERROR, 0, 0};
+      outputs[i] = tmpfile();
+
+      std::cout.flush();
+      std::cerr.flush();
+
+      pid_t pid = outputs[i] ? fork() : -1;
+      if(pid == -1)
+      {
+        error("Fork failed, giving up");
+        for(auto const &child : running)
+          kill(child.first, SIGKILL);
+        while(wait(nullptr) > 0)
+          ;
+        for(FILE *out : outputs)
+          if(out != nullptr)
+            fclose(out);
+        close(result_pipe[0]);
+        close(result_pipe[1]);
+        return smt_convt::P_ERROR;
+      }
+
+      if(pid)
+      {
+        running.emplace(pid, i);
+        continue;
+      }
+
+      // Child process
+      close(result_pipe[0]);
+      dup2(fileno(outputs[i]), STDOUT_FILENO);
+
+      claim_resultt r = results[i];
+      try
+      {
+        std::vector<bool> cone;
+        if(options.get_bool_option("no-slice"))
+        {
+          // Just leave out the other claims, and what follows this one
+          unsigned int j = 0;
+          for(auto const &step : eq->SSA_steps)
+            cone.push_back(j++ <= claims[i].back() && !step.is_assert());
+          for(auto const &step : claims[i])
+            cone[step] = true;
+        }
+        else
+          cone = slicer.cone(claims[i]);
+
+        r.kept = claim_slicet::apply(*eq, cone);
+
+        std::shared_ptr<smt_convt> smt_conv(create_solver_factory(
+          "", options.get_bool_option("int-encoding"), ns, options));
+        smt_conv->set_message_handler(message_handler);
+        smt_conv->set_verbosity(get_verbosity());
+
+        fine_timet solve_start = current_time();
+        eq->convert(*smt_conv);
+        smt_convt::resultt res = smt_conv->dec_solve();
+        r.solve_time = current_time() - solve_start;
+        r.result = res;
+
+        if(res == smt_convt::P_SATISFIABLE)
+        {
+          const symex_target_equationt::SSA_stept *violated = nullptr;
+          for(auto const &step : eq->SSA_steps)
+          {
+            if(
+              !step.ignore && step.is_assert() &&
+              smt_conv->l_get(step.cond_ast).is_false())
+            {
+              violated = &step;
+              break;
+            }
+          }
+
+          error_trace(smt_conv, eq, violated);
+        }
+      }
+      catch(...)
+      {
+        r.result = smt_convt::P_ERROR;
+      }
+
+      std::cout.flush();
+      auto const len = write(result_pipe[1], &r, sizeof(r));
+      (void)len;
+      _exit(0);
+    }
+
+    int wstatus;
+    pid_t pid = waitpid(-1, &wstatus, 0);
+    if(pid == -1)
+    {
+      if(errno == EINTR)
+        continue;
+      break;
+    }
+
+    claim_resultt r;
+    while(read(result_pipe[0], &r, sizeof(r)) == sizeof(r))
+      results[r.claim] = r;
+
+    auto it = running.find(pid);
+    if(it == running.end())
+      continue;
+
+    unsigned int finished = it->second;
+    done[finished] = true;
+    running.erase(it);
+
+    FILE *out = outputs[finished];
+    rewind(out);
+    char buf[4096];
+    for(size_t n; (n = fread(buf, 1, sizeof(buf), out)) > 0;)
+      printed[finished].append(buf, n);
+    fclose(out);
+    outputs[finished] = nullptr;
+
+    // Report what's finished, in claim order
+    for(; reported < claims.size() && done[reported]; reported++)
+    {
+      const claim_resultt &res = results[reported];
+      const symex_target_equationt::SSA_stept &step = *claim_steps[reported];
+
+      std::ostringstream str;
+      str << "Claim " << reported + 1 << " (" << step.comment << ", "
+          << step.source.pc->location.as_string() << "): ";
+      if(res.result == smt_convt::P_SATISFIABLE)
+      {
+        str << "violated";
+        ++num_violated;
+      }
+      else if(res.result == smt_convt::P_UNSATISFIABLE)
+        str << "holds";
+      else
+      {
+        str << "failed";
+        failed = true;
+      }
+      str << " (" << res.kept << " steps, ";
+      output_time(res.solve_time, str);
+      str << "s)";
+      status(str.str());
+
+      // The counterexample, if any
+      std::cout << printed[reported];
+      std::cout.flush();
+      printed[reported].clear();
+      printed[reported].shrink_to_fit();
+    }
+  }
+
+  close(result_pipe[0]);
+  close(result_pipe[1]);
+
+  std::ostringstream str;
+  str << "\nRuntime decision procedure: ";
+  output_time(current_time() - claims_start, str);
+  str << "s";
+  status(str.str());
+
+  if(failed)
+    return smt_convt::P_ERROR;
+
+  str.str("");
+  str << "Claims: " << claims.size() << " checked, " << num_violated
+      << " violated, " << claims.size() - num_violated << " hold";
+  status(str.str());
+
+  return num_violated ? smt_convt::P_SATISFIABLE : smt_convt::P_UNSATISFIABLE;
+#endif
+}
+
 void bmct::report_success()
 {
   status("\nVERIFICATION SUCCESSFUL");
@@ -369,6 +1052,10 @@ void bmct::report_trace(
   bool term = options.get_bool_option("termination");
   bool show_cex = options.get_bool_option("show-cex");
 
+  // Each violated claim already had its trace printed
+  if(options.get_bool_option("multi-property"))
+    return;
+
   switch(res)
   {
   case smt_convt::P_UNSATISFIABLE:
@@ -382,6 +1069,11 @@ void bmct::report_trace(
     break;
 
   case smt_convt::P_SATISFIABLE:
+    // The worker that found the violation printed its trace; a portfolio
+    // leaves no solver here to print it from
+    if(ileave_workers > 1 || runtime_solver == nullptr)
+      break;
+
     if(!bs && show_cex)
     {
       error_trace(runtime_solver, eq);
@@ -475,6 +1167,9 @@ smt_convt::resultt bmct::run(std::shared_ptr<symex_target_equationt> &eq)
   if(options.get_bool_option("schedule"))
     return run_thread(eq);
 
+  if(ileave_workers > 1)
+    return run_parallel_interleavings(eq);
+
   smt_convt::resultt res;
   do
   {
@@ -487,7 +1182,9 @@ smt_convt::resultt bmct::run(std::shared_ptr<symex_target_equationt> &eq)
     fine_timet bmc_start = current_time();
     res = run_thread(eq);
 
-    if(res == smt_convt::P_SATISFIABLE)
+    // Without a solver here, the process that solved the formula already
+    // did this
+    if(res == smt_convt::P_SATISFIABLE && runtime_solver != nullptr)
     {
       if(config.options.get_bool_option("smt-model"))
         runtime_solver->print_model();
@@ -518,9 +1215,309 @@ smt_convt::resultt bmct::run(std::shared_ptr<symex_target_equationt> &eq)
 
   } while(symex->setup_next_formula());
 
+  if(options.get_bool_option("state-hashing"))
+    status(symex->state_hash_stats());
+
   return interleaving_failed > 0 ? smt_convt::P_SATISFIABLE : res;
 }
 
+smt_convt::resultt
+bmct::run_parallel_interleavings(std::shared_ptr<symex_target_equationt> &eq)
+{
+#ifdef _WIN32
+  error("Parallel interleavings are not supported on Windows, sorry");
+  return smt_convt::P_ERROR;
+#else
+  // Interleavings are still explored one after another here, but each
+  // formula is solved in a worker process while symex carries on
+  if(pipe(ileave_pipe))
+  {
+    error("Pipe creation failed, giving up");
+    return smt_convt::P_ERROR;
+  }
+
+  fcntl(ileave_pipe[0], F_SETFL, fcntl(ileave_pipe[0], F_GETFL) | O_NONBLOCK);
+
+  bool all_runs = options.get_bool_option("all-runs");
+  smt_convt::resultt res = smt_convt::P_UNSATISFIABLE;
+  do
+  {
+    // Wait for a free worker
+    while(ileave_jobs.size() >= ileave_workers)
+      collect_interleaving_results(true);
+
+    if(++interleaving_number > 1)
+    {
+      std::cout << "*** Thread interleavings " << interleaving_number << " ***"
+                << std::endl;
+    }
+
+    // Anything but unsat here was settled without a worker
+    smt_convt::resultt thread_res = run_thread(eq);
+    if(thread_res != smt_convt::P_UNSATISFIABLE)
+      res = thread_res;
+
+    collect_interleaving_results(false);
+
+  } while((all_runs || (res == smt_convt::P_UNSATISFIABLE &&
+                        interleaving_failed == 0 && !ileave_error)) &&
+          symex->setup_next_formula());
+
+  // Without --all-runs, the first violation settles it
+  if(!all_runs && interleaving_failed > 0)
+  {
+    for(auto const &job : ileave_jobs)
+    {
+      kill(job.first, SIGKILL);
+      waitpid(job.first, nullptr, 0);
+    }
+
+    ileave_jobs.clear();
+  }
+
+  while(!ileave_jobs.empty())
+    collect_interleaving_results(true);
+
+  close(ileave_pipe[0]);
+  close(ileave_pipe[1]);
+  ileave_reported.clear();
+
+  if(interleaving_failed > 0)
+    return smt_convt::P_SATISFIABLE;
+
+  if(ileave_error)
+    return smt_convt::P_ERROR;
+
+  return res;
+#endif
+}
+
+smt_convt::resultt
+bmct::solve_interleaving_in_worker(std::shared_ptr<symex_target_equationt> &eq)
+{
+#ifdef _WIN32
+  abort();
+#else
+  std::cout.flush();
+  std::cerr.flush();
+
+  pid_t pid = fork();
+  if(pid == -1)
+  {
+    error("Fork failed, giving up");
+    return smt_convt::P_ERROR;
+  }
+
+  // Parent process: the result arrives later through the pipe
+  if(pid)
+  {
+    ileave_jobs.emplace(pid, interleaving_number);
+    return smt_convt::P_UNSATISFIABLE;
+  }
+
+  // Child process
+  close(ileave_pipe[0]);
+  ileave_workers = 0;
+
+  smt_convt::resultt res;
+  try
+  {
+    runtime_solver = std::shared_ptr<smt_convt>(create_solver_factory(
+      "", options.get_bool_option("int-encoding"), ns, options));
+
+    if(options.get_bool_option("multi-property"))
+      res = run_multi_property(runtime_solver, eq);
+    else
+      res = run_decision_procedure(runtime_solver, eq);
+
+    if(res == smt_convt::P_SATISFIABLE)
+    {
+      if(config.options.get_bool_option("smt-model"))
+        runtime_solver->print_model();
+
+      if(config.options.get_bool_option("bidirectional"))
+        bidirectional_search(runtime_solver, eq);
+
+      report_trace(res, eq);
+    }
+  }
+
+  catch(std::string &error_str)
+  {
+    error(error_str);
+    res = smt_convt::P_ERROR;
+  }
+
+  catch(const char *error_str)
+  {
+    error(error_str);
+    res = smt_convt::P_ERROR;
+  }
+
+  catch(std::bad_alloc &)
+  {
+    std::cout << "Out of memory" << std::endl;
+    res = smt_convt::P_ERROR;
+  }
+
+  std::cout.flush();
+  std::cerr.flush();
+
+  struct ileave_resultt r = {getpid(), res};
+  auto const len = write(ileave_pipe[1], &r, sizeof(r));
+  (void)len;
+  _exit(0);
+#endif
+}
+
+void bmct::collect_interleaving_results(bool block)
+{
+#ifndef _WIN32
+  while(!ileave_jobs.empty())
+  {
+    int wstatus;
+    pid_t pid = waitpid(-1, &wstatus, block ? 0 : WNOHANG);
+    if(pid == -1 && errno == EINTR)
+      continue;
+
+    if(pid <= 0)
+      return;
+
+    // Only wait for the first one
+    block = false;
+
+    struct ileave_resultt r;
+    while(read(ileave_pipe[0], &r, sizeof(r)) == sizeof(r))
+    {
+      ileave_reported.insert(r.pid);
+      if(r.result == smt_convt::P_SATISFIABLE)
+        ++interleaving_failed;
+      else if(r.result == smt_convt::P_ERROR)
+        ileave_error = true;
+    }
+
+    auto it = ileave_jobs.find(pid);
+    if(it == ileave_jobs.end())
+      continue;
+
+    if(!ileave_reported.erase(pid))
+    {
+      error(
+        "Solver process for interleaving " + integer2string(it->second) +
+        " crashed");
+      ileave_error = true;
+    }
+
+    ileave_jobs.erase(it);
+  }
+#endif
+}
+
+smt_convt::resultt bmct::run_k_step_base_case(const BigInt &k_step)
+{
+  options.set_option("unwind", integer2string(k_step));
+
+  std::shared_ptr<goto_symext::symex_resultt> result;
+
+  fine_timet symex_start = current_time();
+  try
+  {
+    // Carry on from the first loop that hit the previous bound; only the
+    // first step, or a run that can't be resumed, starts from scratch
+    if(!symex->resume_from_k_step_checkpoint(k_step))
+      symex->setup_for_new_explore();
+
+    phase_timert symex_phase("symex");
+    result = symex->get_next_formula();
+  }
+
+  catch(std::string &error_str)
+  {
+    error(error_str);
+    return smt_convt::P_ERROR;
+  }
+
+  catch(const char *error_str)
+  {
+    error(error_str);
+    return smt_convt::P_ERROR;
+  }
+
+  catch(std::bad_alloc &)
+  {
+    std::cout << "Out of memory" << std::endl;
+    return smt_convt::P_ERROR;
+  }
+
+  fine_timet symex_stop = current_time();
+
+  k_step_eq = std::dynamic_pointer_cast<symex_target_equationt>(result->target);
+
+  {
+    std::ostringstream str;
+    str << "Symex completed in: ";
+    output_time(symex_stop - symex_start, str);
+    str << "s";
+    str << " (" << k_step_eq->SSA_steps.size() << " assignments)";
+    status(str.str());
+  }
+
+  options.set_option("base-case", true);
+  options.set_option("forward-condition", false);
+  return run_k_step_query(false);
+}
+
+smt_convt::resultt bmct::run_k_step_forward_condition()
+{
+  options.set_option("base-case", false);
+  options.set_option("forward-condition", true);
+  return run_k_step_query(true);
+}
+
+smt_convt::resultt bmct::run_k_step_query(bool forward_condition)
+{
+  assert(k_step_eq != nullptr && "Must run the base case first");
+  auto eq = std::dynamic_pointer_cast<runtime_encoded_equationt>(k_step_eq);
+
+  // Everything symex produced is already in the solver; the question goes in
+  // its own context so that the next k step can build on the formula.
+  eq->push_ctx();
+
+  const smt_convt::ast_vec &v = forward_condition
+                                  ? eq->unwind_vec_list.back()
+                                  : eq->assert_vec_list.back();
+
+  smt_convt::resultt res = smt_convt::P_UNSATISFIABLE;
+  if(!v.empty())
+  {
+    runtime_solver->assert_ast(
+      runtime_solver->make_n_ary(runtime_solver.get(), &smt_convt::mk_or, v));
+
+    std::stringstream ss;
+    ss << "Solving with solver " << runtime_solver->solver_text();
+    status(ss.str());
+
+    phase_timert solve_phase("solving");
+    fine_timet sat_start = current_time();
+    res = runtime_solver->dec_solve();
+    fine_timet sat_stop = current_time();
+    solve_phase.stop();
+
+    std::ostringstream str;
+    str << "Runtime decision procedure: ";
+    output_time(sat_stop - sat_start, str);
+    str << "s";
+    status(str.str());
+  }
+
+  // The model is only valid until the context is popped
+  report_trace(res, k_step_eq);
+  report_result(res);
+
+  eq->pop_ctx();
+  return res;
+}
+
 void bmct::bidirectional_search(
   std::shared_ptr<smt_convt> &smt_conv,
   std::shared_ptr<symex_target_equationt> &eq)
@@ -542,7 +1539,7 @@ void bmct::bidirectional_search(
         return;
 
       // Save the location of the failed assertion
-      frames = ssait.stack_trace;
+      frames = stack_trace_frames(ssait.stack_trace);
       assert_loop_number = ssait.loop_number;
 
       // We are not interested in instructions before the failed assertion yet
@@ -658,6 +1655,7 @@ smt_convt::resultt bmct::run_thread(std::shared_ptr<symex_target_equationt> &eq)
   fine_timet symex_start = current_time();
   try
   {
+    phase_timert symex_phase("symex");
     if(options.get_bool_option("schedule"))
     {
       result = symex->generate_schedule_formula();
@@ -701,11 +1699,38 @@ smt_convt::resultt bmct::run_thread(std::shared_ptr<symex_target_equationt> &eq)
     status(str.str());
   }
 
+  if(esbmct::hash_consing)
+    status(esbmct::hash_cons_stats());
+
+  if(options.get_bool_option("function-summaries"))
+  {
+    const auto &summaries = symex->get_cur_state().function_summaries;
+    unsigned int valid = 0;
+    for(auto const &it : summaries->summaries)
+      valid += it.second.valid;
+
+    std::ostringstream str;
+    str << "Function summaries: " << valid << " of "
+        << summaries->summaries.size() << " called functions summarized, "
+        << summaries->instantiated << " calls replaced";
+    status(str.str());
+  }
+
+  if(
+    options.get_bool_option("smt-symex-guard") ||
+    options.get_bool_option("smt-thread-guard"))
+  {
+    auto rte = std::dynamic_pointer_cast<runtime_encoded_equationt>(eq);
+    if(rte != nullptr)
+      status(rte->question_cache_stats());
+  }
+
   if(options.get_bool_option("double-assign-check"))
     eq->check_for_duplicate_assigns();
 
   try
   {
+    phase_timert slice_phase("slicing");
     fine_timet slice_start = current_time();
     BigInt ignored;
     if(!options.get_bool_option("no-slice"))
@@ -713,6 +1738,7 @@ smt_convt::resultt bmct::run_thread(std::shared_ptr<symex_target_equationt> &eq)
     else
       ignored = simple_slice(eq);
     fine_timet slice_stop = current_time();
+    slice_phase.stop();
 
     {
       std::ostringstream str;
@@ -751,6 +1777,11 @@ smt_convt::resultt bmct::run_thread(std::shared_ptr<symex_target_equationt> &eq)
       return smt_convt::P_SMTLIB;
     }
 
+    // Sliced away assignments were only needed for the output above; steps
+    // encoded during symex keep theirs, as traces still read them
+    if(!options.get_bool_option("smt-during-symex"))
+      eq->release_sliced_steps();
+
     if(result->remaining_claims == 0)
     {
       if(options.get_bool_option("smt-formula-only"))
@@ -763,12 +1794,24 @@ smt_convt::resultt bmct::run_thread(std::shared_ptr<symex_target_equationt> &eq)
       return smt_convt::P_UNSATISFIABLE;
     }
 
+    if(ileave_workers > 1)
+      return solve_interleaving_in_worker(eq);
+
+    if(options.get_option("portfolio") != "")
+      return run_portfolio(eq);
+
+    if(options.get_option("parallel-claims") != "")
+      return run_parallel_claims(eq);
+
     if(!options.get_bool_option("smt-during-symex"))
     {
       runtime_solver = std::shared_ptr<smt_convt>(create_solver_factory(
         "", options.get_bool_option("int-encoding"), ns, options));
     }
 
+    if(options.get_bool_option("multi-property"))
+      return run_multi_property(runtime_solver, eq);
+
     return run_decision_procedure(runtime_solver, eq);
   }
 
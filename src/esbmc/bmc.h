@@ -14,9 +14,11 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <langapi/language_ui.h>
 #include <list>
 #include <map>
+#include <set>
 #include <solvers/smt/smt_conv.h>
 #include <solvers/smtlib/smtlib_conv.h>
 #include <solvers/solve.h>
+#include <sys/types.h>
 #include <util/options.h>
 
 class bmct : public messaget
@@ -37,6 +39,11 @@ public:
   virtual smt_convt::resultt run(std::shared_ptr<symex_target_equationt> &eq);
   ~bmct() override = default;
 
+  // Incremental k-step verification (--incremental-k-step): symex and the
+  // solver are kept between calls, each k only extends the last unwinding
+  smt_convt::resultt run_k_step_base_case(const BigInt &k_step);
+  smt_convt::resultt run_k_step_forward_condition();
+
   void set_ui(language_uit::uit _ui)
   {
     ui = _ui;
@@ -65,7 +72,8 @@ protected:
 
   virtual void error_trace(
     std::shared_ptr<smt_convt> &smt_conv,
-    std::shared_ptr<symex_target_equationt> &eq);
+    std::shared_ptr<symex_target_equationt> &eq,
+    const symex_target_equationt::SSA_stept *claim = nullptr);
 
   virtual void successful_trace();
 
@@ -85,6 +93,38 @@ protected:
     std::shared_ptr<symex_target_equationt> &eq);
 
   smt_convt::resultt run_thread(std::shared_ptr<symex_target_equationt> &eq);
+
+  smt_convt::resultt run_portfolio(std::shared_ptr<symex_target_equationt> &eq);
+
+  smt_convt::resultt run_multi_property(
+    std::shared_ptr<smt_convt> &smt_conv,
+    std::shared_ptr<symex_target_equationt> &eq);
+
+  smt_convt::resultt
+  run_parallel_claims(std::shared_ptr<symex_target_equationt> &eq);
+
+  smt_convt::resultt run_k_step_query(bool forward_condition);
+
+  // Solving interleavings in worker processes (--parallel-interleavings)
+  struct ileave_resultt
+  {
+    pid_t pid;
+    smt_convt::resultt result;
+  };
+
+  smt_convt::resultt
+  run_parallel_interleavings(std::shared_ptr<symex_target_equationt> &eq);
+  smt_convt::resultt
+  solve_interleaving_in_worker(std::shared_ptr<symex_target_equationt> &eq);
+  void collect_interleaving_results(bool block);
+
+  unsigned int ileave_workers;
+  int ileave_pipe[2];
+  std::map<pid_t, BigInt> ileave_jobs;
+  std::set<pid_t> ileave_reported;
+  bool ileave_error;
+
+  std::shared_ptr<symex_target_equationt> k_step_eq;
 };
 
 #endif
@@ -14,10 +14,6 @@ extern "C"
 #include <fcntl.h>
 #include <unistd.h>
 
-#ifdef HAVE_SENDFILE_ESBMC
-#include <sys/sendfile.h>
-#endif
-
 #include <sys/resource.h>
 #include <sys/time.h>
 #include <sys/types.h>
@@ -26,6 +22,7 @@ extern "C"
 
 #include <esbmc/bmc.h>
 #include <esbmc/esbmc_parseoptions.h>
+#include <esbmc/result_cache.h>
 #include <cctype>
 #include <clang-c-frontend/clang_c_language.h>
 #include <util/config.h>
@@ -48,30 +45,26 @@ extern "C"
 #include <util/irep.h>
 #include <langapi/languages.h>
 #include <langapi/mode.h>
+#include <map>
 #include <memory>
 #include <pointer-analysis/goto_program_dereference.h>
 #include <pointer-analysis/show_value_sets.h>
 #include <pointer-analysis/value_set_analysis.h>
 #include <util/symbol.h>
 #include <sys/wait.h>
+#include <util/phase_stats.h>
 #include <util/time_stopping.h>
 
 #ifdef ENABLE_OLD_FRONTEND
 #include <ansi-c/c_preprocess.h>
 #endif
 
-enum PROCESS_TYPE
-{
-  BASE_CASE,
-  FORWARD_CONDITION,
-  INDUCTIVE_STEP,
-  PARENT
-};
-
 struct resultt
 {
   PROCESS_TYPE type;
-  BigInt k;
+  uint64_t k;
+  int result;
+  pid_t pid;
 };
 
 #ifndef _WIN32
@@ -184,6 +177,10 @@ void esbmc_parseoptionst::get_command_line_options(optionst &options)
 
   options.cmdline(cmdline);
 
+  // Has to be on before parsing starts
+  if(cmdline.isset("profile-json") || cmdline.isset("memstats"))
+    phase_statst::enabled = true;
+
   /* graphML generation options check */
   if(cmdline.isset("witness-output"))
     options.set_option("witness-output", cmdline.getval("witness-output"));
@@ -239,6 +236,9 @@ void esbmc_parseoptionst::get_command_line_options(optionst &options)
   else
     options.set_option("deadlock-check", false);
 
+  if(cmdline.isset("hash-cons-irep2"))
+    esbmct::hash_consing = true;
+
   if(cmdline.isset("smt-during-symex"))
   {
     std::cout << "Enabling --no-slice due to presence of --smt-during-symex";
@@ -257,6 +257,103 @@ void esbmc_parseoptionst::get_command_line_options(optionst &options)
     }
   }
 
+  if(cmdline.isset("parallel-interleavings"))
+  {
+#ifdef _WIN32
+    std::cerr << "Parallel interleavings unimplemented on Windows, sorry"
+              << std::endl;
+    abort();
+#else
+    if(
+      cmdline.isset("smt-during-symex") ||
+      cmdline.isset("interactive-ileaves") || cmdline.isset("portfolio"))
+    {
+      std::cerr << "--parallel-interleavings can't be used with "
+                   "--smt-during-symex, --interactive-ileaves or --portfolio"
+                << std::endl;
+      abort();
+    }
+#endif
+  }
+
+  if(cmdline.isset("parallel-claims"))
+  {
+#ifdef _WIN32
+    std::cerr << "Parallel claims unimplemented on Windows, sorry"
+              << std::endl;
+    abort();
+#else
+    if(
+      !cmdline.isset("multi-property") || cmdline.isset("smt-during-symex") ||
+      cmdline.isset("parallel-interleavings") || cmdline.isset("portfolio"))
+    {
+      std::cerr << "--parallel-claims needs --multi-property, and can't be "
+                   "used with --smt-during-symex, --parallel-interleavings "
+                   "or --portfolio"
+                << std::endl;
+      abort();
+    }
+#endif
+  }
+
+  if(cmdline.isset("portfolio"))
+  {
+    if(
+      cmdline.isset("smt-during-symex") || cmdline.isset("multi-property") ||
+      cmdline.isset("incremental-k-step"))
+    {
+      std::cerr << "--portfolio can't be used with --smt-during-symex, "
+                   "--multi-property or --incremental-k-step"
+                << std::endl;
+      abort();
+    }
+  }
+
+  if(cmdline.isset("incremental-k-step"))
+  {
+    if(
+      cmdline.isset("termination") ||
+      (!cmdline.isset("k-induction") && !cmdline.isset("incremental-bmc") &&
+       !cmdline.isset("falsification")))
+    {
+      std::cerr << "--incremental-k-step can only be used with --k-induction, "
+                   "--incremental-bmc or --falsification"
+                << std::endl;
+      abort();
+    }
+
+    // The base case and forward condition are checked once per k, on one
+    // formula, rather than once per context bound
+    if(cmdline.isset("incremental-cb"))
+    {
+      std::cerr << "--incremental-k-step can't be used with --incremental-cb"
+                << std::endl;
+      abort();
+    }
+
+    // Requires solvers that can push and pop contexts
+    if(
+      !cmdline.isset("z3") && !cmdline.isset("mathsat") &&
+      !cmdline.isset("yices"))
+    {
+      std::cerr << "--incremental-k-step requires a solver with incremental "
+                   "support; please specify --z3, --mathsat or --yices"
+                << std::endl;
+      abort();
+    }
+  }
+
+  if(cmdline.isset("memspace-encoding"))
+  {
+    std::string memspace = cmdline.getval("memspace-encoding");
+    if(memspace != "pairwise" && memspace != "ordered")
+    {
+      std::cerr << "Unknown memory space encoding \"" << memspace
+                << "\"; use pairwise or ordered" << std::endl;
+      abort();
+    }
+  }
+
   if(cmdline.isset("base-case"))
   {
     options.set_option("base-case", true);
@@ -458,6 +555,25 @@ int esbmc_parseoptionst::doit()
   if(opts.get_bool_option("skip-bmc"))
     return 0;
 
+  std::unique_ptr<result_cachet> cache;
+  if(cmdline.isset("result-cache") && result_cachet::cacheable(opts))
+  {
+    cache = std::unique_ptr<result_cachet>(new result_cachet(
+      cmdline.getval("result-cache"),
+      strtoul(cmdline.getval("result-cache-max-entries"), nullptr, 10)));
+    cache->compute_key(context, goto_functions, opts);
+
+    int res;
+    bool hit = cache->lookup(res, opts.get_option("witness-output"));
+    if(cmdline.isset("result-cache-stats"))
+      status(cache->stats() + (hit ? ", hit" : ", miss"));
+
+    if(hit)
+      return res;
+
+    cache->begin_capture();
+  }
+
   // set the context-bound verification parameters
   set_context_bound_params();
 
@@ -465,86 +581,51 @@ int esbmc_parseoptionst::doit()
   bmct bmc(goto_functions, opts, context, ui_message_handler);
   set_verbosity_msg(bmc);
 
-  return do_incremental_bmc(bmc, opts);
-}
+  int res = do_incremental_bmc(bmc, opts);
 
-int esbmc_parseoptionst::doit_k_induction_parallel()
-{
-  // Pipes for communication between processes
-  int forward_pipe[2], backward_pipe[2];
-
-  // Process type
-  PROCESS_TYPE process_type = PARENT;
+  // Only a verdict is worth replaying; anything else may not happen again
+  if(
+    cache &&
+    (res == smt_convt::P_UNSATISFIABLE || res == smt_convt::P_SATISFIABLE))
+    cache->store(res, opts.get_option("witness-output"));
 
-  if(pipe(forward_pipe))
-  {
-    status("\nPipe Creation Failed, giving up.");
-    _exit(1);
-  }
+  return res;
+}
 
-  if(pipe(backward_pipe))
+static const char *k_induction_step_name(PROCESS_TYPE type)
+{
+  switch(type)
   {
-    status("\nPipe Creation Failed, giving up.");
-    _exit(1);
+  case BASE_CASE:
+    return "base case";
+  case FORWARD_CONDITION:
+    return "forward condition";
+  case INDUCTIVE_STEP:
+    return "inductive step";
+  default:
+    return "parent";
   }
+}
 
-  /* Set file descriptor non-blocking */
-  fcntl(
-    backward_pipe[0], F_SETFL, fcntl(backward_pipe[0], F_GETFL) | O_NONBLOCK);
-
-  pid_t children_pid[3];
-  short num_p = 0;
-
-  // We need to fork 3 times: one for each step
-  for(unsigned p = 0; p < 3; ++p)
-  {
-    pid_t pid = fork();
-
-    if(pid == -1)
-    {
-      status("\nFork Failed, giving up.");
-      _exit(1);
-    }
-
-    // Child process
-    if(!pid)
-    {
-      process_type = PROCESS_TYPE(p);
-      break;
-    }
-    // Parent process
+int esbmc_parseoptionst::doit_k_induction_parallel()
+{
+  optionst opts;
+  get_command_line_options(opts);
 
-    children_pid[p] = pid;
-    ++num_p;
-  }
+  // The program is only built here; every job is forked from this process
+  // and inherits it
+  if(get_goto_program(opts, goto_functions))
+    return 6;
 
-  if(process_type == PARENT && num_p != 3)
+  if(cmdline.isset("show-claims"))
   {
-    std::cerr << "Child processes were not created sucessfully." << std::endl;
-    abort();
+    const namespacet ns(context);
+    show_claims(ns, get_ui(), goto_functions);
+    return 0;
   }
 
-  optionst opts;
-
-  if(process_type != PARENT)
-  {
-    // Get full set of options
-    get_command_line_options(opts);
-
-    // Generate goto functions and set claims
-    if(get_goto_program(opts, goto_functions))
-      return 6;
-
-    if(cmdline.isset("show-claims"))
-    {
-      const namespacet ns(context);
-      show_claims(ns, get_ui(), goto_functions);
-      return 0;
-    }
-
-    if(set_claims(goto_functions))
-      return 7;
-  }
+  if(set_claims(goto_functions))
+    return 7;
 
   // Get max number of iterations
   BigInt max_k_step = cmdline.isset("unlimited-k-steps")
@@ -554,479 +635,297 @@ int esbmc_parseoptionst::doit_k_induction_parallel()
   // Get the increment
   unsigned k_step_inc = strtoul(cmdline.getval("k-step"), nullptr, 10);
 
-  // All processes were created successfully
-  switch(process_type)
-  {
-  case PARENT:
+  // Get the number of jobs that may run at the same time
+  unsigned num_workers =
+    strtoul(cmdline.getval("k-induction-workers"), nullptr, 10);
+  if(num_workers == 0)
+    num_workers = 1;
+
+  // Pipe where every job writes its verdict
+  int result_pipe[2];
+  if(pipe(result_pipe))
   {
-    // Communication to child processes
-    close(forward_pipe[1]);
-    close(backward_pipe[0]);
+    error("Pipe creation failed, giving up");
+    return 1;
+  }
 
-    struct resultt a_result;
-    bool bc_finished = false, fc_finished = false, is_finished = false;
-    BigInt bc_solution = max_k_step, fc_solution = max_k_step,
-           is_solution = max_k_step;
+  /* Set file descriptor non-blocking */
+  fcntl(result_pipe[0], F_SETFL, fcntl(result_pipe[0], F_GETFL) | O_NONBLOCK);
 
-    // Keep reading until we find an answer
-    while(!(bc_finished && fc_finished && is_finished))
-    {
-      // Perform read and interpret the number of bytes read
-      int read_size = read(forward_pipe[0], &a_result, sizeof(resultt));
-      if(read_size != sizeof(resultt))
-      {
-        if(read_size == 0)
-        {
-          // Client hung up; continue on, but don't interpret the result.
-          ;
-        }
-        else
-        {
-          // Invalid size read.
-          std::cerr << "Short read communicating with kinduction children"
-                    << std::endl;
-          std::cerr << "Size " << read_size << ", expected " << sizeof(resultt)
-                    << std::endl;
-          abort();
-        }
-      }
+  // Next k to hand out for each step, and the largest k worth trying. There
+  // is no inductive step for k = 1
+  BigInt next_k[3] = {1, 1, 2};
+  BigInt max_k[3] = {max_k_step, max_k_step, max_k_step};
+  if(opts.get_bool_option("disable-forward-condition"))
+    max_k[FORWARD_CONDITION] = 0;
+  if(opts.get_bool_option("disable-inductive-step"))
+    max_k[INDUCTIVE_STEP] = 0;
 
-      // Eventually the parent process will check if the child process is alive
+  struct jobt
+  {
+    PROCESS_TYPE type;
+    BigInt k;
+  };
+  std::map<pid_t, jobt> running;
 
-      // Check base case process
-      if(!bc_finished)
-      {
-        int status;
-        pid_t result = waitpid(children_pid[0], &status, WNOHANG);
-        if(result == 0)
-        {
-          // Child still alive
-        }
-        else if(result == -1)
-        {
-          // Error
-        }
-        else
-        {
-          std::cout << "**** WARNING: Base case process crashed." << std::endl;
-          bc_finished = fc_finished = is_finished = true;
-        }
-      }
+  // Smallest k where a bug or a proof was found (0 for none), and the
+  // largest k the base case has shown to be bug free
+  BigInt bug_k = 0, proof_k = 0, bc_safe_k = 0;
+  PROCESS_TYPE proof_type = PARENT;
+  bool gave_up = false;
 
-      // Check forward condition process
-      if(!fc_finished)
-      {
-        int status;
-        pid_t result = waitpid(children_pid[1], &status, WNOHANG);
-        if(result == 0)
-        {
-          // Child still alive
-        }
-        else if(result == -1)
-        {
-          // Error
-        }
-        else
-        {
-          std::cout << "**** WARNING: Forward condition process crashed."
-                    << std::endl;
+  auto kill_job = [&running](std::map<pid_t, jobt>::iterator it) {
+    std::cout << "*** Cancelling " << k_induction_step_name(it->second.type)
+              << " (k = " << it->second.k << ")" << std::endl;
+    kill(it->first, SIGKILL);
+    return running.erase(it);
+  };
 
-          fc_finished = bc_finished = is_finished = true;
-        }
-      }
+  while(bug_k == 0 && !gave_up)
+  {
+    // A proof only holds once the base case is bug free up to its k
+    if(proof_k != 0 && bc_safe_k >= proof_k)
+      break;
 
-      // Check inductive step process
-      if(!is_finished)
+    if(proof_k != 0)
+    {
+      // Higher forward conditions and inductive steps are moot now, and a
+      // single base case for some k >= proof_k is enough
+      max_k[FORWARD_CONDITION] = max_k[INDUCTIVE_STEP] = 0;
+
+      BigInt keep_k = 0;
+      for(auto const &job : running)
+        if(
+          job.second.type == BASE_CASE && job.second.k >= proof_k &&
+          (keep_k == 0 || job.second.k < keep_k))
+          keep_k = job.second.k;
+
+      for(auto it = running.begin(); it != running.end();)
       {
-        int status;
-        pid_t result = waitpid(children_pid[2], &status, WNOHANG);
-        if(result == 0)
-        {
-          // Child still alive
-        }
-        else if(result == -1)
-        {
-          // Error
-        }
+        const jobt &job = it->second;
+        if(
+          (job.type != BASE_CASE && job.k > proof_k) ||
+          (job.type == BASE_CASE && keep_k != 0 && job.k > keep_k))
+          it = kill_job(it);
         else
-        {
-          std::cout << "**** WARNING: Inductive step process crashed."
-                    << std::endl;
-
-          is_finished = bc_finished = fc_finished = true;
-        }
+          ++it;
       }
 
-      switch(a_result.type)
+      if(keep_k == 0)
       {
-      case BASE_CASE:
-        bc_finished = true;
-        bc_solution = a_result.k;
-        break;
-
-      case FORWARD_CONDITION:
-        fc_finished = true;
-        fc_solution = a_result.k;
-        break;
+        next_k[BASE_CASE] = proof_k;
+        max_k[BASE_CASE] = proof_k;
+      }
+      else
+        max_k[BASE_CASE] = 0;
+    }
 
-      case INDUCTIVE_STEP:
-        is_finished = true;
-        is_solution = a_result.k;
-        break;
+    // Hand out jobs, lowest k first
+    while(running.size() < num_workers)
+    {
+      int type = -1;
+      for(int t = BASE_CASE; t <= INDUCTIVE_STEP; ++t)
+      {
+        if(next_k[t] > max_k[t])
+          continue;
 
-      default:
-        std::cerr << "Message from unrecognized k-induction child "
-                  << "process" << std::endl;
-        abort();
+        if(type == -1 || next_k[t] < next_k[type])
+          type = t;
       }
 
-      // If either the base case found a bug or the forward condition
-      // finds a solution, present the result
-      if(bc_finished && (bc_solution != 0) && (bc_solution != max_k_step))
+      if(type == -1)
         break;
 
-      // If the either the forward condition or inductive step finds a
-      // solution, first check if base case couldn't find a bug in that code,
-      // if there is no bug, inductive step can present the result
+      jobt job = {PROCESS_TYPE(type), next_k[type]};
+      next_k[type] += k_step_inc;
 
-      if(fc_finished && (fc_solution != 0) && (fc_solution != max_k_step))
+      pid_t pid = fork();
+      if(pid == -1)
       {
-        // If base case finished, then we can present the result
-        if(bc_finished)
-          break;
-
-        // Otherwise, ask base case for a solution
-
-        // Struct to keep the result
-        struct resultt r = {process_type, 0};
-
-        r.k = fc_solution;
-
-        // Write result
-        auto const len = write(backward_pipe[1], &r, sizeof(r));
-        assert(len == sizeof(r) && "short write");
-        (void)len; //ndebug
+        // Don't leave jobs running behind us
+        error("Fork failed, giving up");
+        for(auto const &job : running)
+          kill(job.first, SIGKILL);
+        while(wait(nullptr) > 0)
+          ;
+        close(result_pipe[0]);
+        close(result_pipe[1]);
+        return 1;
       }
 
-      if(is_finished && (is_solution != 0) && (is_solution != max_k_step))
+      // Child process
+      if(!pid)
       {
-        // If base case finished, then we can present the result
-        if(bc_finished)
-          break;
-
-        // Otherwise, ask base case for a solution
-
-        // Struct to keep the result
-        struct resultt r = {process_type, 0};
-
-        r.k = is_solution;
-
-        // Write result
-        auto const len = write(backward_pipe[1], &r, sizeof(r));
-        assert(len == sizeof(r) && "short write");
-        (void)len; //ndebug
+        close(result_pipe[0]);
+        return do_k_induction_job(opts, job.type, job.k, result_pipe[1]);
       }
-    }
-
-    for(int i : children_pid)
-      kill(i, SIGKILL);
 
-    // Check if a solution was found by the base case
-    if(bc_finished && (bc_solution != 0) && (bc_solution != max_k_step))
-    {
-      std::cout << std::endl
-                << "Bug found by the base case (k = " << bc_solution << ")"
-                << std::endl;
-      std::cout << "VERIFICATION FAILED" << std::endl;
-      return true;
+      running.emplace(pid, job);
+      std::cout << "*** Starting " << k_induction_step_name(job.type)
+                << " (k = " << job.k << ")" << std::endl;
     }
 
-    // Check if a solution was found by the forward condition
-    if(fc_finished && (fc_solution != 0) && (fc_solution != max_k_step))
-    {
-      // We should only present the result if the base case finished
-      // and haven't crashed (if it crashed, bc_solution will be UINT_MAX
-      if(bc_finished && (bc_solution != max_k_step))
-      {
-        std::cout << std::endl
-                  << "Solution found by the forward condition; "
-                  << "all states are reachable (k = " << fc_solution << ")"
-                  << std::endl;
-        std::cout << "VERIFICATION SUCCESSFUL" << std::endl;
-        return false;
-      }
-    }
+    // Nothing left to try
+    if(running.empty())
+      break;
 
-    // Check if a solution was found by the inductive step
-    if(is_finished && (is_solution != 0) && (is_solution != max_k_step))
+    int wstatus;
+    pid_t pid = waitpid(-1, &wstatus, 0);
+    if(pid == -1)
     {
-      // We should only present the result if the base case finished
-      // and haven't crashed (if it crashed, bc_solution will be UINT_MAX
-      if(bc_finished && (bc_solution != max_k_step))
-      {
-        std::cout << std::endl
-                  << "Solution found by the inductive step "
-                  << "(k = " << is_solution << ")" << std::endl;
-        std::cout << "VERIFICATION SUCCESSFUL" << std::endl;
-        return false;
-      }
-    }
-
-    // Couldn't find a bug or a proof for the current deepth
-    std::cout << std::endl << "VERIFICATION UNKNOWN" << std::endl;
-    return false;
-    break;
-  }
+      if(errno == EINTR)
+        continue;
 
-  case BASE_CASE:
-  {
-    // Set that we are running base case
-    opts.set_option("base-case", true);
-    opts.set_option("forward-condition", false);
-    opts.set_option("inductive-step", false);
-
-    // Start communication to the parent process
-    close(forward_pipe[0]);
-    close(backward_pipe[1]);
-
-    // Struct to keep the result
-    struct resultt r = {process_type, 0};
+      std::cerr << "Failed waiting for k-induction jobs" << std::endl;
+      abort();
+    }
 
-    // Run bmc and only send results in two occasions:
-    // 1. A bug was found, we send the step where it was found
-    // 2. It couldn't find a bug
-    for(BigInt k_step = 1; k_step <= max_k_step; k_step += k_step_inc)
+    // Read every verdict available; cancelled jobs may still have finished
+    // before they were killed
+    bool reported = false;
+    struct resultt r;
+    while(read(result_pipe[0], &r, sizeof(resultt)) == sizeof(resultt))
     {
-      bmct bmc(goto_functions, opts, context, ui_message_handler);
-      set_verbosity_msg(bmc);
-
-      bmc.options.set_option("unwind", integer2string(k_step));
+      if(r.pid == pid)
+        reported = true;
 
-      std::cout << std::endl << "*** K-Induction Loop Iteration ";
-      std::cout << k_step;
-      std::cout << " ***" << std::endl;
-      std::cout << "*** Checking base case" << std::endl;
+      BigInt k = r.k;
+      bool unsat = r.result == smt_convt::P_UNSATISFIABLE;
+      std::cout << "*** Finished " << k_induction_step_name(r.type)
+                << " (k = " << k << "): ";
 
-      // If an exception was thrown, we should abort the process
-      int res = 1;
-      try
-      {
-        res = do_incremental_bmc(bmc, opts);
-      }
-      catch(...)
-      {
-        break;
-      }
-
-      // Send information to parent if no bug was found
-      if(res == smt_convt::P_SATISFIABLE)
+      switch(r.type)
       {
-        r.k = k_step;
-
-        // Write result
-        auto const len = write(forward_pipe[1], &r, sizeof(r));
-        assert(len == sizeof(r) && "short write");
-        (void)len; //ndebug
-
-        std::cout << "BASE CASE PROCESS FINISHED." << std::endl;
-
-        return 1;
-      }
-
-      // Check if the parent process is asking questions
-
-      // Perform read and interpret the number of bytes read
-      struct resultt a_result;
-      int read_size = read(backward_pipe[0], &a_result, sizeof(resultt));
-      if(read_size != sizeof(resultt))
-      {
-        if(read_size == 0)
-        {
-          // Client hung up; continue on, but don't interpret the result.
-          continue;
-        }
-        if(read_size == -1 && errno == EAGAIN)
+      case BASE_CASE:
+        if(unsat)
         {
-          // No data available yet
-          continue;
+          std::cout << "no bug found" << std::endl;
+          if(k > bc_safe_k)
+            bc_safe_k = k;
         }
         else
         {
-          // Invalid size read.
-          std::cerr << "Short read communicating with kinduction parent"
-                    << std::endl;
-          std::cerr << "Size " << read_size << ", expected " << sizeof(resultt)
-                    << std::endl;
-          abort();
+          std::cout << "bug found" << std::endl;
+          if(bug_k == 0 || k < bug_k)
+            bug_k = k;
         }
-      }
-
-      // We only receive messages from the parent
-      assert(a_result.type == PARENT);
-
-      // If the value being asked is greater or equal the current step,
-      // then we can stop the base case. It can be equal, because we
-      // have just checked the current value of k
-
-      if(a_result.k >= k_step)
         break;
 
-      // Otherwise, we just need to check the base case for k = a_result.k
-      k_step = max_k_step = a_result.k;
-    }
-
-    // Send information to parent that a bug was not found
-    r.k = 0;
-
-    auto const len = write(forward_pipe[1], &r, sizeof(r));
-    assert(len == sizeof(r) && "short write");
-    (void)len; //ndebug
-
-    std::cout << "BASE CASE PROCESS FINISHED." << std::endl;
-    break;
-  }
-
-  case FORWARD_CONDITION:
-  {
-    // Set that we are running forward condition
-    opts.set_option("base-case", false);
-    opts.set_option("forward-condition", true);
-    opts.set_option("inductive-step", false);
-
-    // Start communication to the parent process
-    close(forward_pipe[0]);
-    close(backward_pipe[1]);
-
-    // Struct to keep the result
-    struct resultt r = {process_type, 0};
-
-    // Run bmc and only send results in two occasions:
-    // 1. A proof was found, we send the step where it was found
-    // 2. It couldn't find a proof
-    for(BigInt k_step = 2; k_step <= max_k_step; k_step += k_step_inc)
-    {
-      if(opts.get_bool_option("disable-forward-condition"))
+      case FORWARD_CONDITION:
+      case INDUCTIVE_STEP:
+        if(unsat)
+        {
+          std::cout << "property proved" << std::endl;
+          if(proof_k == 0 || k < proof_k)
+          {
+            proof_k = k;
+            proof_type = r.type;
+          }
+        }
+        else
+          std::cout << "unable to prove" << std::endl;
         break;
 
-      bmct bmc(goto_functions, opts, context, ui_message_handler);
-      set_verbosity_msg(bmc);
-
-      bmc.options.set_option("unwind", integer2string(k_step));
-
-      std::cout << std::endl << "*** K-Induction Loop Iteration ";
-      std::cout << k_step;
-      std::cout << " ***" << std::endl;
-      std::cout << "*** Checking forward condition" << std::endl;
-
-      // If an exception was thrown, we should abort the process
-      int res = 1;
-      try
-      {
-        res = do_incremental_bmc(bmc, opts);
-      }
-      catch(...)
-      {
-        break;
+      default:
+        std::cerr << "Message from unrecognized k-induction job" << std::endl;
+        abort();
       }
+    }
 
-      // Send information to parent if no bug was found
-      if(res == smt_convt::P_UNSATISFIABLE)
-      {
-        r.k = k_step;
-
-        // Write result
-        auto const len = write(forward_pipe[1], &r, sizeof(r));
-        assert(len == sizeof(r) && "short write");
-        (void)len; //ndebug
+    auto it = running.find(pid);
+    if(it == running.end())
+      continue;
 
-        std::cout << "FORWARD CONDITION PROCESS FINISHED." << std::endl;
+    // A job that exits without a verdict crashed
+    if(!reported)
+    {
+      std::cout << "**** WARNING: " << k_induction_step_name(it->second.type)
+                << " process crashed (k = " << it->second.k << ")"
+                << std::endl;
 
-        return 0;
-      }
+      // Without the base case, no verdict can be given
+      if(it->second.type == BASE_CASE)
+        gave_up = true;
     }
 
-    // Send information to parent that it couldn't prove the code
-    r.k = 0;
-
-    auto const len = write(forward_pipe[1], &r, sizeof(r));
-    assert(len == sizeof(r) && "short write");
-    (void)len; //ndebug
-
-    std::cout << "FORWARD CONDITION PROCESS FINISHED." << std::endl;
-    break;
+    running.erase(it);
   }
 
-  case INDUCTIVE_STEP:
-  {
-    // Set that we are running inductive step
-    opts.set_option("base-case", false);
-    opts.set_option("forward-condition", false);
-    opts.set_option("inductive-step", true);
-
-    // Start communication to the parent process
-    close(forward_pipe[0]);
-    close(backward_pipe[1]);
-
-    // Struct to keep the result
-    struct resultt r = {process_type, 0};
-
-    // Run bmc and only send results in two occasions:
-    // 1. A proof was found, we send the step where it was found
-    // 2. It couldn't find a proof
-    for(BigInt k_step = 2; k_step <= max_k_step; k_step += k_step_inc)
-    {
-      bmct bmc(goto_functions, opts, context, ui_message_handler);
-      set_verbosity_msg(bmc);
-
-      bmc.options.set_option("unwind", integer2string(k_step));
+  for(auto const &job : running)
+    kill(job.first, SIGKILL);
 
-      std::cout << std::endl << "*** K-Induction Loop Iteration ";
-      std::cout << k_step + 1;
-      std::cout << " ***" << std::endl;
-      std::cout << "*** Checking inductive step" << std::endl;
-
-      // If an exception was thrown, we should abort the process
-      int res = 1;
-      try
-      {
-        res = do_incremental_bmc(bmc, opts);
-      }
-      catch(...)
-      {
-        break;
-      }
+  while(wait(nullptr) > 0)
+    ;
 
-      // Send information to parent if no bug was found
-      if(res == smt_convt::P_UNSATISFIABLE)
-      {
-        r.k = k_step;
+  // Check if a solution was found by the base case
+  if(bug_k != 0)
+  {
+    std::cout << std::endl
+              << "Bug found by the base case (k = " << bug_k << ")"
+              << std::endl;
+    std::cout << "VERIFICATION FAILED" << std::endl;
+    return true;
+  }
 
-        // Write result
-        auto const len = write(forward_pipe[1], &r, sizeof(r));
-        assert(len == sizeof(r) && "short write");
-        (void)len; //ndebug
+  // Check if a solution was found by the forward condition or the inductive
+  // step, and the base case is bug free up to that k
+  if(proof_k != 0 && bc_safe_k >= proof_k)
+  {
+    if(proof_type == FORWARD_CONDITION)
+      std::cout << std::endl
+                << "Solution found by the forward condition; "
+                << "all states are reachable (k = " << proof_k << ")"
+                << std::endl;
+    else
+      std::cout << std::endl
+                << "Solution found by the inductive step "
+                << "(k = " << proof_k << ")" << std::endl;
 
-        std::cout << "INDUCTIVE STEP PROCESS FINISHED." << std::endl;
+    std::cout << "VERIFICATION SUCCESSFUL" << std::endl;
+    return false;
+  }
 
-        return res;
-      }
-    }
+  // Couldn't find a bug or a proof for the current deepth
+  std::cout << std::endl << "VERIFICATION UNKNOWN" << std::endl;
+  return false;
+}
 
-    // Send information to parent that it couldn't prove the code
-    r.k = 0;
+int esbmc_parseoptionst::do_k_induction_job(
+  optionst &opts,
+  PROCESS_TYPE type,
+  const BigInt &k_step,
+  int result_fd)
+{
+  bool unsat = false;
+  switch(type)
+  {
+  case BASE_CASE:
+    unsat = !do_base_case(opts, goto_functions, k_step);
+    break;
 
-    auto const len = write(forward_pipe[1], &r, sizeof(r));
-    assert(len == sizeof(r) && "short write");
-    (void)len; //ndebug
+  case FORWARD_CONDITION:
+    unsat = !do_forward_condition(opts, goto_functions, k_step);
+    break;
 
-    std::cout << "INDUCTIVE STEP PROCESS FINISHED." << std::endl;
+  case INDUCTIVE_STEP:
+    unsat = !do_inductive_step(opts, goto_functions, k_step);
     break;
-  }
 
   default:
     assert(0 && "Unknown process type.");
   }
 
+  struct resultt r = {type,
+                      k_step.to_uint64(),
+                      unsat ? smt_convt::P_UNSATISFIABLE
+                            : smt_convt::P_SATISFIABLE,
+                      getpid()};
+
+  // Write result
+  auto const len = write(result_fd, &r, sizeof(r));
+  assert(len == sizeof(r) && "short write");
+  (void)len; //ndebug
+
   return 0;
 }
 
@@ -1056,17 +955,36 @@ int esbmc_parseoptionst::doit_k_induction()
   // Get the increment
   unsigned k_step_inc = strtoul(cmdline.getval("k-step"), nullptr, 10);
 
+  std::unique_ptr<bmct> k_step_bmc = setup_incremental_k_step(opts);
+
   for(BigInt k_step = 1; k_step <= max_k_step; k_step += k_step_inc)
   {
     std::cout << "\n*** Iteration number ";
     std::cout << k_step;
     std::cout << " ***\n";
 
-    if(do_base_case(opts, goto_functions, k_step))
-      return true;
+    if(k_step_bmc)
+    {
+      smt_convt::resultt res = do_base_case_incremental(*k_step_bmc, k_step);
+      if(res == smt_convt::P_ERROR)
+        return 1;
+      if(res == smt_convt::P_SATISFIABLE)
+        return true;
 
-    if(!do_forward_condition(opts, goto_functions, k_step))
-      return false;
+      res = do_forward_condition_incremental(*k_step_bmc, k_step);
+      if(res == smt_convt::P_ERROR)
+        return 1;
+      if(res == smt_convt::P_UNSATISFIABLE)
+        return false;
+    }
+    else
+    {
+      if(do_base_case(opts, goto_functions, k_step))
+        return true;
+
+      if(!do_forward_condition(opts, goto_functions, k_step))
+        return false;
+    }
 
     if(!do_inductive_step(opts, goto_functions, k_step))
       return false;
@@ -1104,13 +1022,23 @@ int esbmc_parseoptionst::doit_falsification()
   // Get the increment
   unsigned k_step_inc = strtoul(cmdline.getval("k-step"), nullptr, 10);
 
+  std::unique_ptr<bmct> k_step_bmc = setup_incremental_k_step(opts);
+
   for(BigInt k_step = 1; k_step <= max_k_step; k_step += k_step_inc)
   {
     std::cout << "\n*** Iteration number ";
     std::cout << integer2string(k_step);
     std::cout << " ***\n";
 
-    if(do_base_case(opts, goto_functions, k_step))
+    if(k_step_bmc)
+    {
+      smt_convt::resultt res = do_base_case_incremental(*k_step_bmc, k_step);
+      if(res == smt_convt::P_ERROR)
+        return 1;
+      if(res == smt_convt::P_SATISFIABLE)
+        return true;
+    }
+    else if(do_base_case(opts, goto_functions, k_step))
       return true;
   }
 
@@ -1146,17 +1074,36 @@ int esbmc_parseoptionst::doit_incremental()
   // Get the increment
   unsigned k_step_inc = strtoul(cmdline.getval("k-step"), nullptr, 10);
 
+  std::unique_ptr<bmct> k_step_bmc = setup_incremental_k_step(opts);
+
   for(BigInt k_step = 1; k_step <= max_k_step; k_step += k_step_inc)
   {
     std::cout << "\n*** Iteration number ";
     std::cout << k_step;
     std::cout << " ***\n";
 
-    if(do_base_case(opts, goto_functions, k_step))
-      return true;
+    if(k_step_bmc)
+    {
+      smt_convt::resultt res = do_base_case_incremental(*k_step_bmc, k_step);
+      if(res == smt_convt::P_ERROR)
+        return 1;
+      if(res == smt_convt::P_SATISFIABLE)
+        return true;
 
-    if(!do_forward_condition(opts, goto_functions, k_step))
-      return false;
+      res = do_forward_condition_incremental(*k_step_bmc, k_step);
+      if(res == smt_convt::P_ERROR)
+        return 1;
+      if(res == smt_convt::P_UNSATISFIABLE)
+        return false;
+    }
+    else
+    {
+      if(do_base_case(opts, goto_functions, k_step))
+        return true;
+
+      if(!do_forward_condition(opts, goto_functions, k_step))
+        return false;
+    }
   }
 
   status("Unable to prove or falsify the program, giving up.");
@@ -1374,6 +1321,125 @@ int esbmc_parseoptionst::do_inductive_step(
   return true;
 }
 
+static bool spawns_threads(const goto_functionst &goto_functions)
+{
+  forall_goto_functions(f_it, goto_functions)
+  {
+    forall_goto_program_instructions(i_it, f_it->second.body)
+    {
+      if(!i_it->is_function_call())
+        continue;
+
+      const code_function_call2t &call = to_code_function_call2t(i_it->code);
+      if(
+        is_symbol2t(call.function) &&
+        to_symbol2t(call.function).thename == "c:@F@__ESBMC_spawn_thread")
+        return true;
+    }
+  }
+
+  return false;
+}
+
+std::unique_ptr<bmct>
+esbmc_parseoptionst::setup_incremental_k_step(optionst &opts)
+{
+  if(!opts.get_bool_option("incremental-k-step"))
+    return nullptr;
+
+  // Steps that are still run from scratch (e.g., the inductive step) share
+  // these options, and must not try to take checkpoints
+  opts.set_option("incremental-k-step", false);
+
+  // Resuming symex is only done for sequential programs; other interleavings
+  // would have to be explored again for every k
+  if(spawns_threads(goto_functions))
+  {
+    status(
+      "Disabling --incremental-k-step, the program contains threads; "
+      "each k step will be checked from scratch");
+    return nullptr;
+  }
+
+  // Base case and forward condition are checked on one formula, encoded
+  // while symex runs: assertions and unwinding bounds are collected apart,
+  // and each is solved in its own context
+  k_step_options = opts;
+  k_step_options.set_option("incremental-k-step", true);
+  k_step_options.set_option("base-case", true);
+  k_step_options.set_option("forward-condition", false);
+  k_step_options.set_option("inductive-step", false);
+  k_step_options.set_option("no-unwinding-assertions", true);
+  k_step_options.set_option("partial-loops", false);
+  k_step_options.set_option("smt-during-symex", true);
+  k_step_options.set_option("no-slice", true);
+
+  std::unique_ptr<bmct> bmc(
+    new bmct(goto_functions, k_step_options, context, ui_message_handler));
+  set_verbosity_msg(*bmc);
+  bmc->set_ui(get_ui());
+  return bmc;
+}
+
+smt_convt::resultt esbmc_parseoptionst::do_base_case_incremental(
+  bmct &bmc,
+  const BigInt &k_step)
+{
+  std::cout << "*** Checking base case\n";
+  smt_convt::resultt res = bmc.run_k_step_base_case(k_step);
+  switch(res)
+  {
+  case smt_convt::P_UNSATISFIABLE:
+  case smt_convt::P_SMTLIB:
+    return smt_convt::P_UNSATISFIABLE;
+
+  case smt_convt::P_SATISFIABLE:
+    std::cout << "\nBug found (k = " << k_step << ")\n";
+    return res;
+
+  case smt_convt::P_ERROR:
+    error("Base case failed (k = " + integer2string(k_step) + "), giving up");
+    return res;
+
+  default:
+    std::cout << "Unknown BMC result\n";
+    abort();
+  }
+}
+
+smt_convt::resultt esbmc_parseoptionst::do_forward_condition_incremental(
+  bmct &bmc,
+  const BigInt &k_step)
+{
+  // Without a forward condition, nothing is proved
+  if(bmc.options.get_bool_option("disable-forward-condition"))
+    return smt_convt::P_SATISFIABLE;
+
+  std::cout << "*** Checking forward condition\n";
+  smt_convt::resultt res = bmc.run_k_step_forward_condition();
+  switch(res)
+  {
+  case smt_convt::P_SATISFIABLE:
+  case smt_convt::P_SMTLIB:
+    return smt_convt::P_SATISFIABLE;
+
+  case smt_convt::P_UNSATISFIABLE:
+    std::cout << "\nSolution found by the forward condition; "
+              << "all states are reachable (k = " << k_step << ")\n";
+    return res;
+
+  case smt_convt::P_ERROR:
+    error(
+      "Forward condition failed (k = " + integer2string(k_step) +
+      "), giving up");
+    return res;
+
+  default:
+    std::cout << "Unknown BMC result\n";
+    abort();
+  }
+}
+
 bool esbmc_parseoptionst::set_claims(goto_functionst &goto_functions)
 {
   try
@@ -1426,8 +1492,10 @@ bool esbmc_parseoptionst::get_goto_program(
     else
     {
       // Parsing
+      phase_timert parse_phase("parse");
       if(parse())
         return true;
+      parse_phase.stop();
       if(cmdline.isset("parse-tree-too") || cmdline.isset("parse-tree-only"))
       {
         assert(language_files.filemap.size());
@@ -1439,10 +1507,12 @@ bool esbmc_parseoptionst::get_goto_program(
       }
 
       // Typecheking (old frontend) or adjust (clang frontend)
+      phase_timert typecheck_phase("typecheck");
       if(typecheck())
         return true;
       if(final())
         return true;
+      typecheck_phase.stop();
 
       // we no longer need any parse trees or language files
       clear_parse();
@@ -1460,6 +1530,7 @@ bool esbmc_parseoptionst::get_goto_program(
       // Ahem
       migrate_namespace_lookup = new namespacet(context);
 
+      phase_timert convert_phase("goto_convert");
       goto_convert(context, options, goto_functions, ui_message_handler);
     }
 
@@ -1544,15 +1615,17 @@ void esbmc_parseoptionst::preprocessing()
 
 bool esbmc_parseoptionst::read_goto_binary(goto_functionst &goto_functions)
 {
-  std::ifstream in(cmdline.getval("binary"), std::ios::binary);
+  phase_timert load_phase("goto_binary");
 
-  if(!in)
-  {
-    error(std::string("Failed to open `") + cmdline.getval("binary") + "'");
+  if(::read_goto_binary(
+       cmdline.getval("binary"),
+       context,
+       goto_functions,
+       *get_message_handler()))
     return true;
-  }
 
-  ::read_goto_binary(in, context, goto_functions, *get_message_handler());
+  // Function bodies the entry point can't reach are never decoded
+  goto_functions.load_reachable(goto_functions.main_id());
 
   return false;
 }
@@ -1568,6 +1641,7 @@ bool esbmc_parseoptionst::process_goto_program(
     // do partial inlining
     if(!cmdline.isset("no-inlining"))
     {
+      phase_timert inline_phase("inlining");
       if(cmdline.isset("full-inlining"))
         goto_inline(goto_functions, options, ns, ui_message_handler);
       else
@@ -1597,7 +1671,10 @@ bool esbmc_parseoptionst::process_goto_program(
       goto_termination(goto_functions, ui_message_handler);
     }
 
-    goto_check(ns, options, goto_functions);
+    {
+      phase_timert check_phase("goto_check");
+      goto_check(ns, options, goto_functions);
+    }
 
     // show it?
     if(cmdline.isset("show-goto-value-sets"))
@@ -1700,14 +1777,17 @@ int esbmc_parseoptionst::do_bmc(bmct &bmc)
   if(res == smt_convt::P_ERROR)
     abort();
 
-#ifdef HAVE_SENDFILE_ESBMC
   if(bmc.options.get_bool_option("memstats"))
+    phase_statst::output_json(std::cerr);
+
+  if(bmc.options.get_option("profile-json") != "")
   {
-    int fd = open("/proc/self/status", O_RDONLY);
-    sendfile(2, fd, nullptr, 100000);
-    close(fd);
+    std::ofstream out(bmc.options.get_option("profile-json").c_str());
+    if(!out)
+      error("failed to open profile file");
+    else
+      phase_statst::output_json(out);
   }
-#endif
 
   return res;
 }
@@ -1787,6 +1867,13 @@ void esbmc_parseoptionst::help()
        "in GraphML format\n"
        " --old-frontend               parse source files using our old "
        "frontend (deprecated)\n"
+       " --parallel-frontend nr       parse and convert the source files in "
+       "nr processes\n"
+       "                              (0 for one per core), linking them in "
+       "order\n"
+       " --frontend-cache dir         keep the ESBMC intrinsics precompiled, "
+       "and clang's\n"
+       "                              headers, in dir for later runs\n"
        " --result-only                do not print the counter-example\n"
 #ifdef _WIN32
        " --i386-macos                 set MACOS/I386 architecture\n"
@@ -1816,8 +1903,19 @@ void esbmc_parseoptionst::help()
        " --no-unwinding-assertions    do not generate unwinding assertions\n"
        " --partial-loops              permit paths with partial loops\n"
        " --no-slice                   do not remove unused equations\n"
+       " --multi-property             verify every claim in a single run, "
+       "reporting each\n"
+       "                              violated claim with its own "
+       "counterexample\n"
+       " --parallel-claims nr         with --multi-property, solve each "
+       "claim on its own\n"
+       "                              slice, nr at a time (0 for one per "
+       "CPU)\n"
        " --extended-try-analysis      check all the try block, even when an "
        "exception is thrown\n"
+       " --function-summaries         execute side effect free functions "
+       "once, and\n"
+       "                              reuse their return value at every call\n"
 
        "\nIncremental BMC\n"
        " --falsification              incremental loop unwinding for bug "
@@ -1841,6 +1939,9 @@ void esbmc_parseoptionst::help()
        " --ir                         use solver with integer/real arithmetic\n"
        " --smtlib                     use SMT lib format\n"
        " --smtlib-solver-prog         SMT lib program name\n"
+       " --portfolio s1,s2,...        run those of the listed solvers that "
+       "are built in\n"
+       "                              parallel and take the first answer\n"
        " --output <filename>          output VCCs in SMT lib format to given "
        "file\n"
        " --fixedbv                    encode floating-point as fixed "
@@ -1857,6 +1958,11 @@ void esbmc_parseoptionst::help()
        "--tuple-sym-flattener         encode tuples using our tuple to symbol "
        "API\n"
        "--array-flattener             encode arrays using our array API\n"
+       "--memspace-encoding mode      keep objects apart pairwise (default), "
+       "or ordered\n"
+       "                              by allocation, which is linear in the "
+       "number of\n"
+       "                              objects\n"
        "--no-return-value-opt         disable return value optimization to "
        "compute the stack size\n"
 
@@ -1895,13 +2001,19 @@ void esbmc_parseoptionst::help()
        " --forward-condition          check the forward condition\n"
        " --inductive-step             check the inductive step\n"
        " --k-induction                prove by k-induction \n"
-       " --k-induction-parallel       prove by k-induction, running each step "
-       "on a separate\n"
-       "                              process\n"
+       " --k-induction-parallel       prove by k-induction, running the "
+       "steps for several\n"
+       "                              values of k on separate processes\n"
+       " --k-induction-workers nr     set number of processes for "
+       "--k-induction-parallel\n"
+       "                              (default is 3)\n"
        " --k-step nr                  set k increment (default is 1)\n"
        " --max-k-step nr              set max number of iteration (default is "
        "50)\n"
        " --unlimited-k-steps          set max number of iteration to UINT_MAX\n"
+       " --incremental-k-step         keep symex and solver state between k "
+       "steps of the\n"
+       "                              base case and forward condition\n"
        " --show-cex                   print the counter-example produced by "
        "the inductive step\n"
 
@@ -1922,6 +2034,9 @@ void esbmc_parseoptionst::help()
        " --no-por                     do not do partial order reduction\n"
        " --all-runs                   check all interleavings, even if a bug "
        "was already found\n"
+       " --parallel-interleavings nr  solve up to nr interleavings at once "
+       "on separate\n"
+       "                              processes\n"
        " --initial-context-bound nr   set the initial context-bound for "
        "incremental verification (default is 2)\n"
        " --context-bound-step nr      set k context bound increment (default "
@@ -1936,10 +2051,24 @@ void esbmc_parseoptionst::help()
        "or \"2g\"\n"
        " --timeout                    configure time limit, integer followed "
        "by {s,m,h}\n"
-       " --memstats                   print memory usage statistics\n"
+       " --memstats                   print time and memory used by each "
+       "phase, as JSON, to stderr\n"
+       " --profile-json file          write time and memory used by each "
+       "phase, and symex\n"
+       "                              counters, as JSON to file\n"
        " --no-simplify                do not simplify any expression\n"
+       " --hash-cons-irep2            share structurally equal expressions "
+       "(experimental)\n"
        " --no-propagation             disable constant propagation\n"
        " --enable-core-dump           do not disable core dump output\n"
+       " --result-cache dir           reuse results of identical runs stored in "
+       "dir\n"
+       " --result-cache-max-entries nr\n"
+       "                              evict the least recently used results "
+       "past nr\n"
+       "                              (default is 10000, 0 is unlimited)\n"
+       " --result-cache-stats         print the number of cached results and "
+       "their size\n"
        " --interval-analysis          enable interval analysis and add assumes "
        "to the program\n"
        "\n";
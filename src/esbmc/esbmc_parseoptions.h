@@ -12,6 +12,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <esbmc/bmc.h>
 #include <goto-programs/goto_convert_functions.h>
 #include <langapi/language_ui.h>
+#include <memory>
 #include <util/cmdline.h>
 #include <util/options.h>
 #include <util/parseoptions.h>
@@ -19,6 +20,14 @@ Author: Daniel Kroening, kroening@kroening.com
 
 extern const struct opt_templ esbmc_options[];
 
+enum PROCESS_TYPE
+{
+  BASE_CASE,
+  FORWARD_CONDITION,
+  INDUCTIVE_STEP,
+  PARENT
+};
+
 class esbmc_parseoptionst : public parseoptions_baset, public language_uit
 {
 public:
@@ -62,6 +71,17 @@ protected:
     goto_functionst &goto_functions,
     const BigInt &k_step);
 
+  int do_k_induction_job(
+    optionst &opts,
+    PROCESS_TYPE type,
+    const BigInt &k_step,
+    int result_fd);
+
+  std::unique_ptr<bmct> setup_incremental_k_step(optionst &opts);
+  smt_convt::resultt do_base_case_incremental(bmct &bmc, const BigInt &k_step);
+  smt_convt::resultt
+  do_forward_condition_incremental(bmct &bmc, const BigInt &k_step);
+
   bool read_goto_binary(goto_functionst &goto_functions);
 
   bool set_claims(goto_functionst &goto_functions);
@@ -90,6 +110,9 @@ private:
   int initial_context_bound;
   int max_context_bound;
   int context_bound_inc;
+
+  /* options of the bmct kept alive by --incremental-k-step */
+  optionst k_step_options;
 };
 
 #endif
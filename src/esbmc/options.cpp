@@ -63,6 +63,8 @@ const struct opt_templ esbmc_options[] = {
   {0, "witness-producer", string, ""},
   {0, "witness-programfile", string, ""},
   {0, "old-frontend", switc, ""},
+  {0, "parallel-frontend", number, ""},
+  {0, "frontend-cache", string, ""},
   {0, "result-only", switc, ""},
   {0, "i386-linux", switc, ""},
   {0, "i386-macos", switc, ""},
@@ -79,10 +81,13 @@ const struct opt_templ esbmc_options[] = {
   {0, "partial-loops", switc, ""},
   {0, "unroll-loops", switc, ""},
   {0, "no-slice", switc, ""},
+  {0, "multi-property", switc, ""},
+  {0, "parallel-claims", number, ""},
   {0, "slice-assumes", switc, ""},
   {0, "extended-try-analysis", switc, ""},
   {0, "skip-bmc", switc, ""},
   {0, "no-return-value-opt", switc, ""},
+  {0, "function-summaries", switc, ""},
 
   // IBMC
   {0, "incremental-bmc", switc, ""},
@@ -100,6 +105,7 @@ const struct opt_templ esbmc_options[] = {
   {0, "ir", switc, ""},
   {0, "smtlib", switc, ""},
   {0, "smtlib-solver-prog", string, ""},
+  {0, "portfolio", string, ""},
   {0, "output", string, ""},
   {0, "floatbv", switc, ""},
   {0, "fixedbv", switc, ""},
@@ -107,6 +113,7 @@ const struct opt_templ esbmc_options[] = {
   {0, "tuple-node-flattener", switc, ""},
   {0, "tuple-sym-flattener", switc, ""},
   {0, "array-flattener", switc, ""},
+  {0, "memspace-encoding", string, ""},
 
   // Incremental SMT
   {0, "smt-during-symex", switc, ""},
@@ -137,6 +144,8 @@ const struct opt_templ esbmc_options[] = {
   {0, "inductive-step", switc, ""},
   {0, "k-induction", switc, ""},
   {0, "k-induction-parallel", switc, ""},
+  {0, "k-induction-workers", number, "3"},
+  {0, "incremental-k-step", switc, ""},
   {0, "k-step", number, "1"},
   {0, "max-k-step", number, "50"},
   {0, "unlimited-k-steps", switc, ""},
@@ -154,6 +163,7 @@ const struct opt_templ esbmc_options[] = {
   {0, "state-hashing", switc, ""},
   {0, "no-por", switc, ""},
   {0, "all-runs", switc, ""},
+  {0, "parallel-interleavings", number, ""},
   {0, "incremental-cb", switc, ""},
   {0, "context-bound-step", number, "5"},
   {0, "max-context-bound", number, "15"},
@@ -163,10 +173,15 @@ const struct opt_templ esbmc_options[] = {
   // Miscellaneous
   {0, "memlimit", string, ""},
   {0, "memstats", switc, ""},
+  {0, "profile-json", string, ""},
   {0, "timeout", string, ""},
   {0, "enable-core-dump", switc, ""},
+  {0, "result-cache", string, ""},
+  {0, "result-cache-max-entries", number, "10000"},
+  {0, "result-cache-stats", switc, ""},
   {0, "no-simplify", switc, ""},
   {0, "no-propagation", switc, ""},
+  {0, "hash-cons-irep2", switc, ""},
   {0, "interval-analysis", switc, ""},
 
   // DEBUG options
@@ -0,0 +1,315 @@
+/*******************************************************************\
+
+Module: On-disk cache of verification results
+
+\*******************************************************************/
+
+#include <ac_config.h>
+#include <algorithm>
+#include <cstdio>
+#include <dirent.h>
+#include <esbmc/result_cache.h>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <util/crypto_hash.h>
+#include <utime.h>
+#include <vector>
+
+extern "C" uint8_t *esbmc_version_string;
+
+static const char *const result_cache_magic = "ESBMC-RESULT-CACHE 1";
+
+namespace
+{
+/** Stream buffer that passes everything through, keeping a copy */
+class tee_buft : public std::streambuf
+{
+public:
+  tee_buft(std::streambuf *_orig, std::string &_copy)
+    : orig(_orig), copy(_copy)
+  {
+  }
+
+protected:
+  int overflow(int c) override
+  {
+    if(c == traits_type::eof())
+      return traits_type::not_eof(c);
+
+    copy.push_back(traits_type::to_char_type(c));
+    return orig->sputc(traits_type::to_char_type(c));
+  }
+
+  std::streamsize xsputn(const char *s, std::streamsize n) override
+  {
+    copy.append(s, n);
+    return orig->sputn(s, n);
+  }
+
+  int sync() override
+  {
+    return orig->pubsync();
+  }
+
+  std::streambuf *orig;
+  std::string &copy;
+};
+} // namespace
+
+static void ingest_string(crypto_hash &hash, const std::string &str)
+{
+  uint32_t len = str.size();
+  hash.ingest(&len, sizeof(len));
+  hash.ingest(str.data(), str.size());
+}
+
+template <typename T>
+static void ingest_value(crypto_hash &hash, const T &val)
+{
+  hash.ingest(&val, sizeof(val));
+}
+
+static bool copy_file(const std::string &from, const std::string &to)
+{
+  std::ifstream in(from, std::ios::binary);
+  if(!in)
+    return false;
+
+  std::ofstream out(to, std::ios::binary);
+  out << in.rdbuf();
+  return bool(out);
+}
+
+result_cachet::result_cachet(const std::string &_dir, unsigned int _max_entries)
+  : dir(_dir), max_entries(_max_entries), orig_cout(nullptr)
+{
+  mkdir(dir.c_str(), 0777);
+}
+
+result_cachet::~result_cachet()
+{
+  end_capture();
+}
+
+bool result_cachet::cacheable(const optionst &options)
+{
+  return options.get_option("output") == "" &&
+         !options.get_bool_option("smt-formula-only") &&
+         !options.get_bool_option("smt-formula-too") &&
+         !options.get_bool_option("interactive-ileaves");
+}
+
+void result_cachet::compute_key(
+  const contextt &context,
+  const goto_functionst &goto_functions,
+  const optionst &options)
+{
+  crypto_hash hash;
+
+  ingest_string(hash, ESBMC_VERSION);
+  ingest_string(hash, reinterpret_cast<const char *>(esbmc_version_string));
+
+  // Where results and witnesses go doesn't change them
+  for(auto const &it : options.option_map)
+  {
+    if(it.first.compare(0, 12, "result-cache") == 0)
+      continue;
+    if(it.first == "witness-output")
+      continue;
+
+    ingest_string(hash, it.first);
+    ingest_string(hash, it.second);
+  }
+
+  context.foreach_operand_in_order([&hash](const symbolt &s) {
+    ingest_string(hash, s.id.as_string());
+    ingest_value(hash, s.type.full_hash());
+    ingest_value(hash, s.value.full_hash());
+  });
+
+  for(auto const &it : goto_functions.function_map)
+  {
+    ingest_string(hash, it.first.as_string());
+    ingest_value(hash, it.second.body_available);
+    if(!it.second.body_available)
+      continue;
+
+    for(auto const &instr : it.second.body.instructions)
+    {
+      ingest_value(hash, instr.type);
+      ingest_value(hash, instr.location.full_hash());
+      ingest_value(hash, instr.inductive_step_instruction);
+      ingest_value(hash, instr.inductive_assertion);
+
+      if(!is_nil_expr(instr.guard))
+        instr.guard->hash(hash);
+
+      if(!is_nil_expr(instr.code))
+        instr.code->hash(hash);
+
+      for(auto const &target : instr.targets)
+        ingest_value(hash, target->location_number);
+    }
+  }
+
+  hash.fin();
+  key = hash.to_string();
+}
+
+std::string result_cachet::entry_path(const std::string &ext) const
+{
+  return dir + "/" + key + ext;
+}
+
+bool result_cachet::lookup(int &result, const std::string &witness)
+{
+  std::ifstream in(entry_path(".result"), std::ios::binary);
+  if(!in)
+    return false;
+
+  std::string magic;
+  if(!std::getline(in, magic) || magic != result_cache_magic)
+    return false;
+
+  std::string line;
+  if(!std::getline(in, line))
+    return false;
+  result = atoi(line.c_str());
+
+  if(witness != "" && !copy_file(entry_path(".witness"), witness))
+    return false;
+
+  // Keep recently used entries from being evicted
+  utime(entry_path(".result").c_str(), nullptr);
+
+  std::cout << "Result cache hit: " << key << std::endl;
+  std::cout << in.rdbuf();
+  std::cout.flush();
+  return true;
+}
+
+void result_cachet::begin_capture()
+{
+  if(tee)
+    return;
+
+  std::cout.flush();
+  orig_cout = std::cout.rdbuf();
+  tee.reset(new tee_buft(orig_cout, captured));
+  std::cout.rdbuf(tee.get());
+}
+
+void result_cachet::end_capture()
+{
+  if(!tee)
+    return;
+
+  std::cout.flush();
+  std::cout.rdbuf(orig_cout);
+  tee.reset();
+}
+
+void result_cachet::store(int result, const std::string &witness)
+{
+  end_capture();
+
+  // Write to a temporary first, so that concurrent runs never see half an
+  // entry
+  std::string tmp = entry_path(".tmp." + std::to_string(getpid()));
+  {
+    std::ofstream out(tmp, std::ios::binary);
+    out << result_cache_magic << "\n" << result << "\n" << captured;
+    if(!out)
+    {
+      remove(tmp.c_str());
+      return;
+    }
+  }
+
+  if(witness != "")
+    copy_file(witness, entry_path(".witness"));
+
+  rename(tmp.c_str(), entry_path(".result").c_str());
+  evict();
+}
+
+namespace
+{
+struct cache_entryt
+{
+  std::string name;
+  time_t mtime;
+  off_t size;
+};
+} // namespace
+
+static std::vector<cache_entryt> list_entries(const std::string &dir)
+{
+  std::vector<cache_entryt> entries;
+
+  DIR *d = opendir(dir.c_str());
+  if(d == nullptr)
+    return entries;
+
+  const std::string ext = ".result";
+  while(struct dirent *ent = readdir(d))
+  {
+    std::string name = ent->d_name;
+    if(
+      name.size() <= ext.size() ||
+      name.compare(name.size() - ext.size(), ext.size(), ext) != 0)
+      continue;
+
+    struct stat st;
+    if(stat((dir + "/" + name).c_str(), &st) != 0)
+      continue;
+
+    entries.push_back({name.substr(0, name.size() - ext.size()),
+                       st.st_mtime,
+                       st.st_size});
+  }
+
+  closedir(d);
+  return entries;
+}
+
+void result_cachet::evict()
+{
+  if(max_entries == 0)
+    return;
+
+  std::vector<cache_entryt> entries = list_entries(dir);
+  if(entries.size() <= max_entries)
+    return;
+
+  std::sort(
+    entries.begin(),
+    entries.end(),
+    [](const cache_entryt &a, const cache_entryt &b) {
+      return a.mtime < b.mtime;
+    });
+
+  for(size_t i = 0; i < entries.size() - max_entries; i++)
+  {
+    remove((dir + "/" + entries[i].name + ".result").c_str());
+    remove((dir + "/" + entries[i].name + ".witness").c_str());
+  }
+}
+
+std::string result_cachet::stats() const
+{
+  std::vector<cache_entryt> entries = list_entries(dir);
+
+  off_t size = 0;
+  for(auto const &entry : entries)
+    size += entry.size;
+
+  std::ostringstream str;
+  str << "Result cache " << dir << ": " << entries.size() << " entries, "
+      << size << " bytes";
+  if(max_entries != 0)
+    str << " (limit " << max_entries << " entries)";
+  return str.str();
+}
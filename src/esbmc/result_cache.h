@@ -0,0 +1,72 @@
+/*******************************************************************\
+
+Module: On-disk cache of verification results
+
+\*******************************************************************/
+
+#ifndef CPROVER_ESBMC_RESULT_CACHE_H
+#define CPROVER_ESBMC_RESULT_CACHE_H
+
+#include <goto-programs/goto_functions.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <util/context.h>
+#include <util/options.h>
+
+/** Content addressed cache of verification results (--result-cache).
+ *  The key is a hash of the final goto program, its symbol table, the
+ *  options and the ESBMC build. An entry records the exit code, everything
+ *  printed to stdout while verifying (so the counterexample too), and the
+ *  witness file if one was written. */
+class result_cachet
+{
+public:
+  result_cachet(const std::string &_dir, unsigned int _max_entries);
+  ~result_cachet();
+
+  /** Some runs have side effects other than their output; don't cache them */
+  static bool cacheable(const optionst &options);
+
+  void compute_key(
+    const contextt &context,
+    const goto_functionst &goto_functions,
+    const optionst &options);
+
+  const std::string &get_key() const
+  {
+    return key;
+  }
+
+  /** Replay a recorded result.
+   *  @param result Set to the recorded exit code on a hit.
+   *  @param witness File the recorded witness is copied to, if any.
+   *  @return True on a hit. */
+  bool lookup(int &result, const std::string &witness);
+
+  /** Start recording stdout, for store() */
+  void begin_capture();
+
+  /** Record the verdict of this run, then evict the oldest entries if the
+   *  cache holds more than the maximum. Errors and smtlib dumps must not be
+   *  stored. */
+  void store(int result, const std::string &witness);
+
+  /** Number of entries and their size on disk */
+  std::string stats() const;
+
+protected:
+  std::string entry_path(const std::string &ext) const;
+  void end_capture();
+  void evict();
+
+  std::string dir;
+  unsigned int max_entries;
+  std::string key;
+
+  std::string captured;
+  std::unique_ptr<std::streambuf> tee;
+  std::streambuf *orig_cout;
+};
+
+#endif
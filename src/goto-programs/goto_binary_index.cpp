@@ -0,0 +1,301 @@
+/*******************************************************************\
+
+Module: Random access to indexed goto binaries
+
+\*******************************************************************/
+
+#include <cstring>
+#include <fstream>
+#include <goto-programs/goto_binary_index.h>
+#include <goto-programs/goto_program_irep.h>
+#include <goto-programs/write_goto_binary.h>
+#include <istream>
+#include <sstream>
+#include <streambuf>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+// Reads straight out of the binary's memory, without copying it
+class memory_buft : public std::streambuf
+{
+public:
+  memory_buft(const char *begin, const char *end)
+  {
+    char *b = const_cast<char *>(begin);
+    setg(b, b, const_cast<char *>(end));
+  }
+
+  size_t offset() const
+  {
+    return gptr() - eback();
+  }
+};
+} // namespace
+
+bool goto_binary_indext::is_indexed(const char *data, size_t size)
+{
+  if(size < 7 || memcmp(data, "GBF", 3) != 0)
+    return false;
+
+  memory_buft buf(data + 3, data + size);
+  std::istream in(&buf);
+  return irep_serializationt::read_long(in) == GOTO_BINARY_VERSION;
+}
+
+bool goto_binary_indext::parse(const char *data, size_t size)
+{
+  if(!is_indexed(data, size))
+    return true;
+
+  const char *end = data + size;
+  memory_buft buf(data + 7, end);
+  std::istream in(&buf);
+
+  // The string table; strings are interned only once used
+  unsigned count = irep_serializationt::read_long(in);
+  const char *p = data + 7 + buf.offset();
+  ic.string_table_text.reserve(count);
+  for(unsigned i = 0; i < count; i++)
+  {
+    ic.string_table_text.push_back(p);
+    while(p < end && *p != 0)
+      p += (*p == '\\') ? 2 : 1;
+    if(p >= end)
+      return true;
+    p++;
+  }
+
+  memory_buft index_buf(p, end);
+  in.rdbuf(&index_buf);
+
+  count = irep_serializationt::read_long(in);
+  symbols.resize(count);
+  symbol_numbers.reserve(count);
+  for(unsigned i = 0; i < count && in.good(); i++)
+  {
+    symbol_entryt &entry = symbols[i];
+    entry.name = irepconverter.read_string_ref(in);
+    entry.offset = irep_serializationt::read_long(in);
+
+    unsigned num_deps = irep_serializationt::read_long(in);
+    entry.deps.reserve(num_deps);
+    for(unsigned j = 0; j < num_deps && in.good(); j++)
+      entry.deps.push_back(irep_serializationt::read_long(in));
+
+    symbol_numbers[entry.name] = i;
+  }
+
+  count = irep_serializationt::read_long(in);
+  functions.resize(count);
+  function_numbers.reserve(count);
+  for(unsigned i = 0; i < count && in.good(); i++)
+  {
+    function_entryt &entry = functions[i];
+    entry.name = irepconverter.read_string_ref(in);
+    entry.offset = irep_serializationt::read_long(in);
+
+    unsigned num_deps = irep_serializationt::read_long(in);
+    entry.deps.reserve(num_deps);
+    for(unsigned j = 0; j < num_deps && in.good(); j++)
+      entry.deps.push_back(irep_serializationt::read_long(in));
+
+    function_numbers[entry.name] = i;
+  }
+
+  records_size = irep_serializationt::read_long(in);
+  if(!in.good())
+    return true;
+
+  for(auto const &entry : symbols)
+    for(unsigned dep : entry.deps)
+      if(dep >= symbols.size())
+        return true;
+
+  for(auto const &entry : functions)
+    for(unsigned dep : entry.deps)
+      if(dep >= functions.size())
+        return true;
+
+  records = p + index_buf.offset();
+  return records_size > (size_t)(end - records);
+}
+
+int goto_binary_indext::find_symbol(const irep_idt &name) const
+{
+  auto it = symbol_numbers.find(name);
+  if(it == symbol_numbers.end())
+    return -1;
+
+  return it->second;
+}
+
+int goto_binary_indext::find_function(const irep_idt &name) const
+{
+  auto it = function_numbers.find(name);
+  if(it == function_numbers.end())
+    return -1;
+
+  return it->second;
+}
+
+void goto_binary_indext::read_record(
+  unsigned offset,
+  irept &dest,
+  bool function)
+{
+  if(offset >= records_size)
+    throw "goto binary record out of range";
+
+  memory_buft buf(records + offset, records + records_size);
+  std::istream in(&buf);
+
+  // Records only share strings
+  ic.ireps_on_read.clear();
+
+  if(function)
+    gfconverter.convert(in, dest);
+  else
+    symbolconverter.convert(in, dest);
+}
+
+void goto_binary_indext::read_symbol(unsigned nr, symbolt &symbol)
+{
+  irept t;
+  read_record(symbols[nr].offset, t, false);
+  symbol.from_irep(t);
+}
+
+void goto_binary_indext::read_function(unsigned nr, goto_functiont &function)
+{
+  irept t;
+  read_record(functions[nr].offset, t, true);
+  convert(t, function.body);
+  function.body_available = function.body.instructions.size() > 0;
+}
+
+void goto_binary_indext::read_symbols(contextt &context, goto_functionst &dest)
+{
+  for(unsigned i = 0; i < symbols.size(); i++)
+  {
+    symbolt symbol;
+    read_symbol(i, symbol);
+
+    if(!symbol.is_type && symbol.type.is_code())
+    {
+      // makes sure there is an empty function
+      // for every function symbol and fixes
+      // the function types.
+      dest.function_map[symbol.id].type = to_code_type(symbol.type);
+    }
+    context.add(symbol);
+  }
+}
+
+void goto_binary_indext::read_all(contextt &context, goto_functionst &dest)
+{
+  read_symbols(context, dest);
+
+  for(unsigned i = 0; i < functions.size(); i++)
+    read_function(i, dest.function_map[functions[i].name]);
+}
+
+goto_binary_filet::~goto_binary_filet()
+{
+#ifndef _WIN32
+  if(mapped)
+    munmap(const_cast<char *>(data), size);
+#endif
+}
+
+bool goto_binary_filet::open(const std::string &filename)
+{
+#ifndef _WIN32
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if(fd < 0)
+    return true;
+
+  struct stat st;
+  if(fstat(fd, &st) != 0)
+  {
+    close(fd);
+    return true;
+  }
+
+  // Mapping nothing is an error, and there's nothing to map anyway
+  if(st.st_size != 0)
+  {
+    void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(p != MAP_FAILED)
+    {
+      data = static_cast<const char *>(p);
+      size = st.st_size;
+      mapped = true;
+    }
+  }
+
+  close(fd);
+  if(mapped || st.st_size == 0)
+    return false;
+#endif
+
+  std::ifstream in(filename, std::ios::binary);
+  if(!in)
+    return true;
+
+  std::ostringstream str;
+  str << in.rdbuf();
+  contents = str.str();
+  data = contents.data();
+  size = contents.size();
+  return false;
+}
+
+bool goto_binary_filet::parse()
+{
+  if(index.parse(data, size))
+    return true;
+
+  loaded.resize(index.functions.size(), false);
+  return false;
+}
+
+bool goto_binary_filet::load(
+  const irep_idt &id,
+  goto_functionst &dest,
+  std::vector<irep_idt> &callees)
+{
+  int nr = index.find_function(id);
+  if(nr < 0)
+    return false;
+
+  if(loaded[nr])
+    return true;
+  loaded[nr] = true;
+
+  index.read_function(nr, dest.function_map[id]);
+
+  for(unsigned dep : index.functions[nr].deps)
+    if(!loaded[dep])
+      callees.push_back(index.functions[dep].name);
+
+  return true;
+}
+
+void goto_binary_filet::load_all(goto_functionst &dest)
+{
+  for(unsigned nr = 0; nr < index.functions.size(); nr++)
+  {
+    if(loaded[nr])
+      continue;
+    loaded[nr] = true;
+
+    index.read_function(nr, dest.function_map[index.functions[nr].name]);
+  }
+}
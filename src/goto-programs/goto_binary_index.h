@@ -0,0 +1,135 @@
+/*******************************************************************\
+
+Module: Random access to indexed goto binaries
+
+\*******************************************************************/
+
+#ifndef CPROVER_GOTO_PROGRAMS_GOTO_BINARY_INDEX_H
+#define CPROVER_GOTO_PROGRAMS_GOTO_BINARY_INDEX_H
+
+#include <goto-programs/goto_function_serialization.h>
+#include <goto-programs/goto_functions.h>
+#include <string>
+#include <unordered_map>
+#include <util/context.h>
+#include <util/irep_serialization.h>
+#include <util/symbol_serialization.h>
+#include <vector>
+
+/** Reads an indexed goto binary (see write_goto_binary) in place, from memory
+ *  that must outlive it. Parsing only reads the string table and the index;
+ *  each symbol and function body is decoded when asked for. */
+class goto_binary_indext
+{
+public:
+  goto_binary_indext()
+    : records(nullptr),
+      records_size(0),
+      irepconverter(ic),
+      symbolconverter(ic),
+      gfconverter(ic)
+  {
+  }
+
+  struct symbol_entryt
+  {
+    irep_idt name;
+    unsigned offset;
+    // Symbols this one refers to, by position in the index
+    std::vector<unsigned> deps;
+  };
+
+  struct function_entryt
+  {
+    irep_idt name;
+    unsigned offset;
+    // Functions this one refers to, by position in the index
+    std::vector<unsigned> deps;
+  };
+
+  typedef std::vector<symbol_entryt> symbolst;
+  symbolst symbols;
+
+  typedef std::vector<function_entryt> functionst;
+  functionst functions;
+
+  /** Checks whether data starts like an indexed goto binary */
+  static bool is_indexed(const char *data, size_t size);
+
+  /** Reads the string table and index; true on error */
+  bool parse(const char *data, size_t size);
+
+  /** Position of a symbol in the index, or -1 */
+  int find_symbol(const irep_idt &name) const;
+
+  /** Position of a function body in the index, or -1 */
+  int find_function(const irep_idt &name) const;
+
+  void read_symbol(unsigned nr, symbolt &symbol);
+  void read_function(unsigned nr, goto_functiont &function);
+
+  /** Decodes every symbol, and gives each function its type */
+  void read_symbols(contextt &context, goto_functionst &dest);
+
+  /** Decodes everything, as read_bin_goto_object does for older binaries */
+  void read_all(contextt &context, goto_functionst &dest);
+
+protected:
+  const char *records;
+  size_t records_size;
+
+  irep_serializationt::ireps_containert ic;
+  irep_serializationt irepconverter;
+  symbol_serializationt symbolconverter;
+  goto_function_serializationt gfconverter;
+
+  typedef std::unordered_map<irep_idt, unsigned, irep_id_hash> numberst;
+  numberst symbol_numbers;
+  numberst function_numbers;
+
+  void read_record(unsigned offset, irept &dest, bool function);
+};
+
+/** A goto binary mapped into memory, which decodes function bodies from it
+ *  only once they are asked for */
+class goto_binary_filet : public goto_functionst::body_loadert
+{
+public:
+  goto_binary_filet() : data(nullptr), size(0), mapped(false)
+  {
+  }
+
+  ~goto_binary_filet() override;
+
+  /** Maps the file into memory; true on error */
+  bool open(const std::string &filename);
+
+  bool is_indexed() const
+  {
+    return goto_binary_indext::is_indexed(data, size);
+  }
+
+  /** Reads the index of an indexed binary; true on error */
+  bool parse();
+
+  goto_binary_indext index;
+
+  bool load(
+    const irep_idt &id,
+    goto_functionst &dest,
+    std::vector<irep_idt> &callees) override;
+
+  void load_all(goto_functionst &dest) override;
+
+protected:
+  const char *data;
+  size_t size;
+  bool mapped;
+
+  // Where memory can't be mapped, the file is read into here
+  std::string contents;
+
+  std::vector<bool> loaded;
+};
+
+#endif
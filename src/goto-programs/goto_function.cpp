@@ -213,6 +213,41 @@ void goto_functionst::compute_loop_numbers()
     it.second.body.compute_loop_numbers(nr);
 }
 
+void goto_functionst::load_body(const irep_idt &id)
+{
+  if(!body_loader)
+    return;
+
+  std::vector<irep_idt> callees;
+  body_loader->load(id, *this, callees);
+}
+
+void goto_functionst::load_reachable(const irep_idt &id)
+{
+  if(!body_loader)
+    return;
+
+  std::vector<irep_idt> worklist;
+  if(!body_loader->load(id, *this, worklist))
+  {
+    load_all();
+    return;
+  }
+
+  while(!worklist.empty())
+  {
+    irep_idt callee = worklist.back();
+    worklist.pop_back();
+    body_loader->load(callee, *this, worklist);
+  }
+}
+
+void goto_functionst::load_all()
+{
+  if(body_loader)
+    body_loader->load_all(*this);
+}
+
 void get_local_identifiers(
   const goto_functiont &goto_function,
   std::set<irep_idt> &dest)
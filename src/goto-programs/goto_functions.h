@@ -24,7 +24,9 @@ Date: June 2003
       it++)
 
 #include <goto-programs/goto_program.h>
+#include <memory>
 #include <util/std_types.h>
+#include <vector>
 
 class goto_functiont
 {
@@ -56,10 +58,40 @@ public:
   typedef std::map<irep_idt, goto_functiont> function_mapt;
   function_mapt function_map;
 
+  /** Decodes the function bodies of a goto binary as they are needed; until
+   *  then, those functions have their type but no body. Copies share the
+   *  loader, and a body is decoded only once, so load before copying. */
+  class body_loadert
+  {
+  public:
+    virtual ~body_loadert() = default;
+
+    /** Decodes the body of function id, unless done already, and adds the
+     *  functions it refers to to callees; false if there's no such body */
+    virtual bool load(
+      const irep_idt &id,
+      goto_functionst &dest,
+      std::vector<irep_idt> &callees) = 0;
+
+    virtual void load_all(goto_functionst &dest) = 0;
+  };
+
+  std::shared_ptr<body_loadert> body_loader;
+
+  /** Decodes the body of function id, if it hasn't been yet */
+  void load_body(const irep_idt &id);
+
+  /** Decodes the bodies of function id and everything it may call, or every
+   *  body if there's no function id */
+  void load_reachable(const irep_idt &id);
+
+  void load_all();
+
   ~goto_functionst() = default;
   void clear()
   {
     function_map.clear();
+    body_loader.reset();
   }
 
   void output(const namespacet &ns, std::ostream &out) const;
@@ -84,6 +116,7 @@ public:
   void swap(goto_functionst &other)
   {
     function_map.swap(other.function_map);
+    body_loader.swap(other.body_loader);
   }
 };
 
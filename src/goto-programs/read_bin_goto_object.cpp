@@ -8,16 +8,20 @@ Date: June 2006
 
 \*******************************************************************/
 
+#include <goto-programs/goto_binary_index.h>
 #include <goto-programs/goto_function_serialization.h>
 #include <goto-programs/goto_program_irep.h>
 #include <goto-programs/read_bin_goto_object.h>
+#include <goto-programs/write_goto_binary.h>
 #include <langapi/mode.h>
+#include <sstream>
 #include <util/base_type.h>
 #include <util/irep_serialization.h>
 #include <util/message_stream.h>
 #include <util/namespace.h>
 #include <util/symbol_serialization.h>
 
+// Binaries without an index are still read, as a stream
 #define BINARY_VERSION 1
 
 bool read_bin_goto_object(
@@ -65,6 +69,26 @@ bool read_bin_goto_object(
   {
     unsigned version = irepconverter.read_long(in);
 
+    if(version == GOTO_BINARY_VERSION)
+    {
+      std::ostringstream image;
+      image << "GBF";
+      write_long(image, version);
+      image << in.rdbuf();
+      std::string data = image.str();
+
+      goto_binary_indext index;
+      if(index.parse(data.data(), data.size()))
+      {
+        message_stream.str << "`" << filename << "' is corrupt";
+        message_stream.error();
+        return true;
+      }
+
+      index.read_all(context, functions);
+      return false;
+    }
+
     if(version != BINARY_VERSION)
     {
       message_stream.str
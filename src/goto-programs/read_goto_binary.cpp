@@ -6,8 +6,11 @@ Author:
 
 \*******************************************************************/
 
+#include <fstream>
+#include <goto-programs/goto_binary_index.h>
 #include <goto-programs/read_bin_goto_object.h>
 #include <goto-programs/read_goto_binary.h>
+#include <util/message_stream.h>
 
 void read_goto_binary(
   std::istream &in,
@@ -17,3 +20,38 @@ void read_goto_binary(
 {
   read_bin_goto_object(in, "", context, dest, message_handler);
 }
+
+bool read_goto_binary(
+  const std::string &filename,
+  contextt &context,
+  goto_functionst &dest,
+  message_handlert &message_handler)
+{
+  message_streamt message_stream(message_handler);
+
+  auto file = std::make_shared<goto_binary_filet>();
+  if(file->open(filename))
+  {
+    message_stream.str << "Failed to open `" << filename << "'";
+    message_stream.error();
+    return true;
+  }
+
+  // Older binaries, and anything else, go through the stream reader
+  if(!file->is_indexed())
+  {
+    std::ifstream in(filename, std::ios::binary);
+    return read_bin_goto_object(in, filename, context, dest, message_handler);
+  }
+
+  if(file->parse())
+  {
+    message_stream.str << "`" << filename << "' is corrupt";
+    message_stream.error();
+    return true;
+  }
+
+  file->index.read_symbols(context, dest);
+  dest.body_loader = file;
+  return false;
+}
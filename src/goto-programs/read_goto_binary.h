@@ -20,4 +20,12 @@ void read_goto_binary(
   goto_functionst &dest,
   message_handlert &message_handler);
 
+/** Reads a goto binary file, mapping it into memory. Function bodies are left
+ *  in the file until loaded through dest; true on error. */
+bool read_goto_binary(
+  const std::string &filename,
+  contextt &context,
+  goto_functionst &dest,
+  message_handlert &message_handler);
+
 #endif
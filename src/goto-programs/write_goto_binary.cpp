@@ -8,19 +8,79 @@ Author: CM Wintersteiger
 
 #include <fstream>
 #include <goto-programs/goto_function_serialization.h>
+#include <goto-programs/goto_program_irep.h>
 #include <goto-programs/write_goto_binary.h>
+#include <map>
+#include <set>
+#include <sstream>
+#include <unordered_map>
 #include <util/irep_serialization.h>
 #include <util/message.h>
 #include <util/symbol_serialization.h>
 
-bool write_goto_binary(
+// Records the symbols an irep refers to
+static void generate_symbol_deps(
+  irep_idt name,
+  irept irep,
+  std::multimap<irep_idt, irep_idt> &deps)
+{
+  std::pair<irep_idt, irep_idt> type;
+
+  if(irep.id() == "symbol")
+  {
+    type = std::pair<irep_idt, irep_idt>(name, irep.identifier());
+    deps.insert(type);
+    return;
+  }
+
+  forall_irep(irep_it, irep.get_sub())
+  {
+    if(irep_it->id() == "symbol")
+    {
+      type = std::pair<irep_idt, irep_idt>(name, irep_it->identifier());
+      deps.insert(type);
+      generate_symbol_deps(name, *irep_it, deps);
+    }
+    else if(irep_it->id() == "argument")
+    {
+      type = std::pair<irep_idt, irep_idt>(name, irep_it->cmt_identifier());
+      deps.insert(type);
+    }
+    else
+    {
+      generate_symbol_deps(name, *irep_it, deps);
+    }
+  }
+
+  forall_named_irep(irep_it, irep.get_named_sub())
+  {
+    if(irep_it->second.id() == "symbol")
+    {
+      type = std::pair<irep_idt, irep_idt>(name, irep_it->second.identifier());
+      deps.insert(type);
+    }
+    else if(irep_it->second.id() == "argument")
+    {
+      type =
+        std::pair<irep_idt, irep_idt>(name, irep_it->second.cmt_identifier());
+      deps.insert(type);
+    }
+    else
+    {
+      generate_symbol_deps(name, irep_it->second, deps);
+    }
+  }
+}
+
+// The version 1 format, which can only be read as a whole
+static bool write_stream_goto_binary(
   std::ostream &out,
   const contextt &lcontext,
   goto_functionst &functions)
 {
   // header
   out << "GBF";
-  write_long(out, GOTO_BINARY_VERSION);
+  write_long(out, 1);
 
   irep_serializationt::ireps_containert irepc;
   irep_serializationt irepconverter(irepc);
@@ -50,8 +110,116 @@ bool write_goto_binary(
     }
   }
 
-  //irepconverter.output_map(f);
-  //irepconverter.output_string_map(f);
+  return false;
+}
+
+bool write_goto_binary(
+  std::ostream &out,
+  const contextt &lcontext,
+  goto_functionst &functions,
+  unsigned version)
+{
+  if(version == 1)
+    return write_stream_goto_binary(out, lcontext, functions);
+
+  if(version != GOTO_BINARY_VERSION)
+    return true;
+
+  irep_serializationt::ireps_containert irepc;
+  irepc.use_string_table = true;
+  irep_serializationt irepconverter(irepc);
+  symbol_serializationt symbolconverter(irepc);
+  goto_function_serializationt gfconverter(irepc);
+
+  // Every symbol and function body is a record of its own, sharing only the
+  // string table, so that readers can decode just those they need. The index
+  // gives each record's offset, and the symbols each symbol refers to.
+  std::ostringstream index, records;
+
+  std::vector<const symbolt *> symbols;
+  std::unordered_map<irep_idt, unsigned, irep_id_hash> symbol_numbers;
+  lcontext.foreach_operand([&symbols, &symbol_numbers](const symbolt &s) {
+    symbol_numbers[s.id] = symbols.size();
+    symbols.push_back(&s);
+  });
+
+  write_long(index, symbols.size());
+
+  for(const symbolt *s : symbols)
+  {
+    std::multimap<irep_idt, irep_idt> deps;
+    generate_symbol_deps(s->id, s->value, deps);
+    generate_symbol_deps(s->id, s->type, deps);
+
+    std::set<unsigned> dep_numbers;
+    for(auto const &dep : deps)
+    {
+      auto it = symbol_numbers.find(dep.second);
+      if(it != symbol_numbers.end())
+        dep_numbers.insert(it->second);
+    }
+
+    irepconverter.write_string_ref(index, s->id);
+    write_long(index, records.tellp());
+    write_long(index, dep_numbers.size());
+    for(unsigned nr : dep_numbers)
+      write_long(index, nr);
+
+    irepc.ireps_on_write.clear();
+    symbolconverter.convert(*s, records);
+  }
+
+  std::unordered_map<irep_idt, unsigned, irep_id_hash> function_numbers;
+  forall_goto_functions(it, functions)
+    if(it->second.body_available)
+      function_numbers.emplace(it->first, function_numbers.size());
+
+  write_long(index, function_numbers.size());
+
+  for(auto &it : functions.function_map)
+  {
+    if(it.second.body_available)
+    {
+      it.second.body.compute_location_numbers();
+
+      // Any function a body mentions, it may call
+      irept body;
+      convert(it.second.body, body);
+      std::multimap<irep_idt, irep_idt> deps;
+      generate_symbol_deps(it.first, body, deps);
+
+      std::set<unsigned> dep_numbers;
+      for(auto const &dep : deps)
+      {
+        auto f = function_numbers.find(dep.second);
+        if(f != function_numbers.end())
+          dep_numbers.insert(f->second);
+      }
+
+      irepconverter.write_string_ref(index, it.first);
+      write_long(index, records.tellp());
+      write_long(index, dep_numbers.size());
+      for(unsigned nr : dep_numbers)
+        write_long(index, nr);
+
+      irepc.ireps_on_write.clear();
+      gfconverter.convert(it.second, records);
+    }
+  }
+
+  // header
+  out << "GBF";
+  write_long(out, GOTO_BINARY_VERSION);
+
+  write_long(out, irepc.string_table.size());
+  for(auto const &str : irepc.string_table)
+    write_string(out, str.as_string());
+
+  out << index.str();
+
+  std::string records_str = records.str();
+  write_long(out, records_str.size());
+  out << records_str;
 
   return false;
 }
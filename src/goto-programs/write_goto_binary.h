@@ -9,7 +9,9 @@ Author: CM Wintersteiger
 #ifndef CPROVER_GOTO_PROGRAMS_WRITE_GOTO_BINARY_H_
 #define CPROVER_GOTO_PROGRAMS_WRITE_GOTO_BINARY_H_
 
-#define GOTO_BINARY_VERSION 1
+// Version 2 added the string table and the index, and version 3 the
+// functions each function body refers to; see goto_binary_indext
+#define GOTO_BINARY_VERSION 3
 
 #include <goto-programs/goto_functions.h>
 #include <ostream>
@@ -18,6 +20,7 @@ Author: CM Wintersteiger
 bool write_goto_binary(
   std::ostream &out,
   const contextt &lcontext,
-  goto_functionst &functions);
+  goto_functionst &functions,
+  unsigned version = GOTO_BINARY_VERSION);
 
 #endif
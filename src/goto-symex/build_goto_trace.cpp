@@ -52,7 +52,8 @@ expr2tc build_rhs(std::shared_ptr<smt_convt> &smt_conv, const expr2tc &rhs)
 void build_goto_trace(
   const std::shared_ptr<symex_target_equationt> &target,
   std::shared_ptr<smt_convt> &smt_conv,
-  goto_tracet &goto_trace)
+  goto_tracet &goto_trace,
+  const symex_target_equationt::SSA_stept *claim)
 {
   unsigned step_nr = 0;
 
@@ -68,11 +69,11 @@ void build_goto_trace(
 
     goto_trace_step.thread_nr = SSA_step.source.thread_nr;
     goto_trace_step.pc = SSA_step.source.pc;
-    goto_trace_step.comment = SSA_step.comment;
+    goto_trace_step.comment = id2string(SSA_step.comment);
     goto_trace_step.original_lhs = SSA_step.original_lhs;
     goto_trace_step.type = SSA_step.type;
     goto_trace_step.step_nr = ++step_nr;
-    goto_trace_step.format_string = SSA_step.format_string;
+    goto_trace_step.format_string = id2string(SSA_step.format_string);
 
     goto_trace_step.stack_trace = SSA_step.stack_trace;
 
@@ -105,7 +106,13 @@ void build_goto_trace(
     if(SSA_step.is_assert() || SSA_step.is_assume())
       goto_trace_step.guard = !smt_conv->l_get(SSA_step.cond_ast).is_false();
 
+    if(claim != nullptr && SSA_step.is_assert() && &SSA_step != claim)
+      goto_trace_step.guard = true;
+
     goto_trace.steps.push_back(goto_trace_step);
+
+    if(&SSA_step == claim)
+      break;
   }
 }
 
@@ -135,11 +142,11 @@ void build_successful_goto_trace(
       goto_trace_step.lhs = it->lhs;
       goto_trace_step.rhs = it->rhs;
       goto_trace_step.pc = it->source.pc;
-      goto_trace_step.comment = it->comment;
+      goto_trace_step.comment = id2string(it->comment);
       goto_trace_step.original_lhs = it->original_lhs;
       goto_trace_step.type = it->type;
       goto_trace_step.step_nr = step_nr++;
-      goto_trace_step.format_string = it->format_string;
+      goto_trace_step.format_string = id2string(it->format_string);
       goto_trace_step.stack_trace = it->stack_trace;
     }
   }
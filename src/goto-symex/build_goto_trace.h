@@ -15,10 +15,13 @@ Date: July 2005
 #include <goto-symex/goto_trace.h>
 #include <goto-symex/symex_target_equation.h>
 
+// If claim is given, the trace ends at that assertion, and any other
+// assertion is shown as holding
 void build_goto_trace(
   const std::shared_ptr<symex_target_equationt> &target,
   std::shared_ptr<smt_convt> &smt_conv,
-  goto_tracet &goto_trace);
+  goto_tracet &goto_trace,
+  const symex_target_equationt::SSA_stept *claim = nullptr);
 
 void build_successful_goto_trace(
   const std::shared_ptr<symex_target_equationt> &target,
@@ -1041,36 +1041,29 @@ bool execution_statet::can_execution_continue() const
   return true;
 }
 
-crypto_hash execution_statet::generate_hash() const
+state_hasht execution_statet::generate_hash() const
 {
   auto l2 = std::dynamic_pointer_cast<state_hashing_level2t>(state_level2);
   assert(l2 != nullptr);
 
-  crypto_hash state = l2->generate_l2_state_hash();
-  std::string str = state.to_string();
-
+  state_hash_buildert h;
+  h.digest(l2->generate_l2_state_hash());
   for(const auto &it : threads_state)
-  {
-    goto_programt::const_targett pc = it.source.pc;
-    int id = pc->location_number;
-    std::stringstream s;
-    s << id;
-    str += "!" + s.str();
-  }
+    h.word(it.source.pc->location_number);
 
-  crypto_hash h;
-  h.ingest(str.c_str(), str.size());
-  h.fin();
-
-  return h;
+  return h.finish();
 }
 
-crypto_hash execution_statet::update_hash_for_assignment(const expr2tc &rhs)
+state_hasht execution_statet::update_hash_for_assignment(
+  const irep_idt &lhs,
+  const expr2tc &rhs)
 {
-  crypto_hash h;
-  rhs->hash(h);
-  h.fin();
-  return h;
+  // Expression digests are cached, so shared subexpressions of the values
+  // assigned are only ever hashed once
+  state_hash_buildert h;
+  h.word(lhs.get_no());
+  h.digest(rhs->digest());
+  return h.finish();
 }
 
 void execution_statet::print_stack_traces(unsigned int indent) const
@@ -1263,40 +1256,25 @@ void execution_statet::state_hashing_level2t::make_assignment(
   const expr2tc &const_value,
   const expr2tc &assigned_value)
 {
-  //  crypto_hash hash;
-
   renaming::level2t::make_assignment(lhs_sym, const_value, assigned_value);
 
   // If there's no body to the assignment, don't hash.
   if(!is_nil_expr(assigned_value))
   {
     // XXX - consider whether to use l1 names instead. Recursion, reentrancy.
-    crypto_hash hash = owner->update_hash_for_assignment(assigned_value);
-    std::string orig_name = to_symbol2t(lhs_sym).thename.as_string();
-    current_hashes[orig_name] = hash;
+    const irep_idt &orig_name = to_symbol2t(lhs_sym).thename;
+    state_hasht hash =
+      owner->update_hash_for_assignment(orig_name, assigned_value);
+
+    state_hasht &cur = current_hashes[orig_name];
+    l2_state_hash -= cur;
+    l2_state_hash += hash;
+    cur = hash;
   }
 }
 
-crypto_hash
+state_hasht
 execution_statet::state_hashing_level2t::generate_l2_state_hash() const
 {
-  unsigned int total;
-
-  uint8_t *data = (uint8_t *)alloca(
-    current_hashes.size() * CRYPTO_HASH_SIZE * sizeof(uint8_t));
-
-  total = 0;
-  for(const auto &current_hashe : current_hashes)
-  {
-    memcpy(
-      &data[total * CRYPTO_HASH_SIZE],
-      current_hashe.second.hash,
-      CRYPTO_HASH_SIZE);
-    total++;
-  }
-
-  crypto_hash c;
-  c.ingest(data, total * CRYPTO_HASH_SIZE);
-  c.fin();
-  return c;
+  return l2_state_hash;
 }
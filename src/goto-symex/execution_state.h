@@ -22,6 +22,7 @@
 #include <set>
 #include <util/irep2.h>
 #include <util/message.h>
+#include <util/state_hash.h>
 #include <util/std_expr.h>
 
 class reachability_treet;
@@ -132,9 +133,12 @@ public:
       expr2tc &lhs_symbol,
       const expr2tc &const_value,
       const expr2tc &assigned_value) override;
-    crypto_hash generate_l2_state_hash() const;
-    typedef std::map<irep_idt, crypto_hash> current_state_hashest;
+    state_hasht generate_l2_state_hash() const;
+    /** What each variable contributes to the state hash */
+    typedef std::map<irep_idt, state_hasht> current_state_hashest;
     current_state_hashest current_hashes;
+    /** Sum of current_hashes, kept up to date on each assignment */
+    state_hasht l2_state_hash;
   };
 
   // Macros
@@ -470,20 +474,22 @@ public:
 
   /**
    *  Generate hash of entire execution state.
-   *  This takes all current symbolic assignments to variables contained in the
-   *  l2 renaming object, and their precomputed hashes, concatonates them with
-   *  the current program counter of each thread, and hashes that. This results
-   *  in a full hash of the current execution state.
+   *  This takes the hash of all current symbolic assignments to variables
+   *  contained in the l2 renaming object, which is maintained as they are
+   *  made, and combines it with the current program counter of each thread.
+   *  This results in a full hash of the current execution state.
    *  @return Hash of entire current execution state.
    */
-  crypto_hash generate_hash() const;
+  state_hasht generate_hash() const;
 
   /**
-   *  Generate hash of an expression.
-   *  @param rhs Expression to hash.
-   *  @return Hash of passed in expression.
+   *  Generate hash of an assignment.
+   *  @param lhs Name of the variable assigned to.
+   *  @param rhs Expression assigned to it.
+   *  @return What the assignment contributes to the state hash.
    */
-  crypto_hash update_hash_for_assignment(const expr2tc &rhs);
+  state_hasht
+  update_hash_for_assignment(const irep_idt &lhs, const expr2tc &rhs);
 
   /**
    *  Print stack trace of each thread to stdout.
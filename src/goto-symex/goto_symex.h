@@ -15,6 +15,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <map>
 #include <pointer-analysis/dereference.h>
 #include <stack>
+#include <unordered_map>
 #include <util/i2string.h>
 #include <util/irep2.h>
 #include <util/options.h>
@@ -105,6 +106,28 @@ public:
     unsigned int remaining_claims;
   };
 
+  /** Side effect free behaviour of a callee, see --function-summaries */
+  struct function_summaryt
+  {
+    /** False if the callee does more than compute its return value */
+    bool valid;
+    /** Whether the value depends on globals, read at the call site */
+    bool reads_globals;
+    /** Formal parameters the value is expressed over */
+    std::vector<irep_idt> parameters;
+    /** Return value, nil if the callee returns nothing */
+    expr2tc value;
+  };
+
+  /** Summaries computed so far; these are facts about the program, so every
+   *  thread and interleaving shares them */
+  struct function_summariest
+  {
+    std::map<irep_idt, function_summaryt> summaries;
+    /** Number of calls replaced by the summary of their callee */
+    unsigned int instantiated = 0;
+  };
+
   // Macros
   //
   /**
@@ -269,6 +292,14 @@ protected:
    */
   void phi_function(const statet::goto_statet &goto_state);
 
+  /**
+   *  Fetch the irep2 type of a symbol.
+   *  Types are migrated once per symbol, then cached.
+   *  @param symbol Symbol to fetch the type of.
+   *  @return Migrated type of the symbol.
+   */
+  const type2tc &get_symbol_type(const symbolt &symbol);
+
   /**
    *  Test whether unwinding bound has been exceeded.
    *  This looks up a look number, checks the limit on unwindings against the
@@ -351,6 +382,21 @@ protected:
    */
   bool get_unwind_recursion(const irep_idt &identifier, BigInt unwind);
 
+  /**
+   *  Replace a call by the summary of its callee.
+   *  The summary is computed on the first call to the function. If the
+   *  callee is side effect free and loop free, its return value is assigned
+   *  in one step instead of executing its body.
+   *  @param call Function call being performed.
+   *  @param identifier Name of the called function.
+   *  @param goto_function Body of the called function.
+   *  @return True if the call was performed through its summary.
+   */
+  bool symex_function_summary(
+    const code_function_call2t &call,
+    const irep_idt &identifier,
+    const goto_functiont &goto_function);
+
   /**
    *  Join up function arguments.
    *  Assigns the value of arguments to a function to the actual argument
@@ -791,6 +837,12 @@ protected:
 
   /** Disable return value optimization */
   bool no_return_value_opt;
+  /** Function summaries, or null unless --function-summaries is on */
+  std::shared_ptr<function_summariest> function_summaries;
+  /** Migrated types of symbols, shared with every copy of this object
+   *  @see get_symbol_type */
+  std::shared_ptr<std::unordered_map<irep_idt, type2tc, irep_id_hash>>
+    symbol_types;
   /** Limit size for stack */
   unsigned long stack_limit;
   /** Depth limit, as given by the --depth option */
@@ -826,6 +878,9 @@ protected:
   /** Flag as to whether we're doing a k-induction inductive step.
    *  Corresponds to the option --inductive-step */
   bool inductive_step;
+  /** Flag as to whether symex state is kept between k steps. Corresponds to
+   *  the option --incremental-k-step */
+  bool incremental_k_step;
   /** Set of dereference state records; this field is used as a mailbox between
    *  the dereference code and the caller, who will inspect the contents after
    *  a call to dereference (in INTERNAL mode) completes. */
@@ -425,31 +425,44 @@ void goto_symex_statet::print_stack_trace(unsigned int indent) const
   }
 }
 
-std::vector<stack_framet> goto_symex_statet::gen_stack_trace() const
+stack_tracet goto_symex_statet::gen_stack_trace() const
 {
-  std::vector<stack_framet> trace;
-  call_stackt::const_reverse_iterator it;
-  symex_targett::sourcet src;
-
-  // Format is a vector of strings, each recording a particular function
-  // invocation.
+  std::vector<const framet *> unbuilt;
+  stack_tracet trace;
 
-  for(it = call_stack.rbegin(); it != call_stack.rend(); it++)
+  // Walk down to the top level call, or to the first frame whose node is
+  // already built; that node carries the rest of the trace.
+  for(auto it = call_stack.rbegin(); it != call_stack.rend(); it++)
   {
-    src = it->calling_location;
-
+    // Top level call, or a callee whose frame is still being set up
     if(it->function_identifier == "")
-    { // Top level call
       break;
-    }
-    if(it->function_identifier == "main" && src.pc->location == get_nil_irep())
+
+    if(it->stack_trace)
     {
-      trace.emplace_back(it->function_identifier);
+      trace = it->stack_trace;
+      break;
     }
+
+    unbuilt.push_back(&*it);
+  }
+
+  // Link the missing nodes on, outermost first
+  for(auto it = unbuilt.rbegin(); it != unbuilt.rend(); it++)
+  {
+    const framet &frame = **it;
+    const symex_targett::sourcet &src = frame.calling_location;
+
+    if(
+      frame.function_identifier == "main" &&
+      src.pc->location == get_nil_irep())
+      trace = std::make_shared<const stack_frame_nodet>(
+        stack_framet(frame.function_identifier), trace);
     else
-    {
-      trace.emplace_back(irep_idt(it->function_identifier), src);
-    }
+      trace = std::make_shared<const stack_frame_nodet>(
+        stack_framet(frame.function_identifier, src), trace);
+
+    frame.stack_trace = trace;
   }
 
   return trace;
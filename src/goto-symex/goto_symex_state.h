@@ -82,7 +82,9 @@ public:
   typedef std::map<goto_programt::const_targett, goto_state_listt>
     goto_state_mapt;
   typedef std::vector<framet> call_stackt;
-  typedef std::unordered_set<
+  /** Persistent, so that branch states share it with the state they fork
+   *  from */
+  typedef persistent_sett<
     renaming::level2t::name_record,
     renaming::level2t::name_rec_hash>
     variable_name_sett;
@@ -160,6 +162,9 @@ public:
     /** Record of source of function call. Used when returning from the function
      *  to the caller. */
     symex_targett::sourcet calling_location;
+    /** Stack trace node for this activation, built by gen_stack_trace the
+     *  first time a step inside the function needs it. */
+    mutable stack_tracet stack_trace;
 
     /** End of function instruction location. Jumped to after an in-body return
      * instruction. */
@@ -410,12 +415,12 @@ public:
   void print_stack_trace(unsigned int indent) const;
 
   /**
-   *  Generate set of strings making up a stack trace.
-   *  From the current thread state, produces a set of strings recording the
-   *  current function invocations on the stack, and returns them.
-   *  @return Vector of strings describing the current function calls in state.
+   *  Generate the stack trace of the current thread state.
+   *  Each frame builds its node of the trace once and caches it, so steps
+   *  within the same function activation share one trace.
+   *  @return Trace recording the current function invocations in state.
    */
-  std::vector<stack_framet> gen_stack_trace() const;
+  stack_tracet gen_stack_trace() const;
 
   /**
    *  Fixup types after renaming: we might rename a symbol that we
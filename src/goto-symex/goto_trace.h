@@ -26,7 +26,7 @@ public:
   unsigned step_nr;
 
   // See SSA_stept.
-  std::vector<stack_framet> stack_trace;
+  stack_tracet stack_trace;
 
   bool is_assignment() const
   {
@@ -18,7 +18,6 @@ Author: Lucas Cordeiro, lcc08r@ecs.soton.ac.uk
 #include <goto-symex/goto_symex.h>
 #include <goto-symex/reachability_tree.h>
 #include <util/config.h>
-#include <util/crypto_hash.h>
 #include <util/expr_util.h>
 #include <util/i2string.h>
 #include <util/message.h>
@@ -51,6 +50,7 @@ reachability_treet::reachability_treet(
   interactive_ileaves = options.get_bool_option("interactive-ileaves");
   round_robin = options.get_bool_option("round-robin");
   schedule = options.get_bool_option("schedule");
+  k_step_checkpoint_invalid = false;
 
   if(options.get_bool_option("no-por"))
     por = false;
@@ -65,6 +65,8 @@ void reachability_treet::setup_for_new_explore()
   std::shared_ptr<symex_targett> targ;
 
   execution_states.clear();
+  k_step_checkpoint.reset();
+  k_step_checkpoint_invalid = false;
 
   has_complete_formula = false;
 
@@ -127,12 +129,7 @@ bool reachability_treet::check_for_hash_collision() const
 {
   const execution_statet &ex_state = get_cur_state();
 
-  crypto_hash hash;
-  hash = ex_state.generate_hash();
-  if(hit_hashes.find(hash) != hit_hashes.end())
-    return true;
-
-  return false;
+  return hit_hashes.contains(ex_state.generate_hash());
 }
 
 void reachability_treet::post_hash_collision_cleanup()
@@ -145,9 +142,7 @@ void reachability_treet::update_hash_collision_set()
 {
   execution_statet &ex_state = get_cur_state();
 
-  crypto_hash hash;
-  hash = ex_state.generate_hash();
-  hit_hashes.insert(hash);
+  hit_hashes.insert(ex_state.generate_hash());
 }
 
 void reachability_treet::create_next_state()
@@ -745,6 +740,67 @@ bool reachability_treet::setup_next_formula()
   return reset_to_unexplored_state();
 }
 
+void reachability_treet::save_k_step_checkpoint()
+{
+  if(k_step_checkpoint != nullptr || k_step_checkpoint_invalid)
+    return;
+
+  execution_statet &ex_state = get_cur_state();
+  const goto_symex_statet &state = *ex_state.cur_state;
+  const goto_programt::instructiont &instruction = *state.source.pc;
+  assert(instruction.is_backwards_goto());
+
+  // Loops with their own bound, and gotos to themselves, don't depend on k.
+  if(
+    ex_state.max_unwind == 0 ||
+    ex_state.unwind_set.count(instruction.loop_number) != 0 ||
+    instruction.targets.front() == state.source.pc)
+    return;
+
+  if(state.guard.is_false())
+    return;
+
+  // Is this iteration going to hit the bound?
+  auto it = state.loop_iterations.find(instruction.loop_number);
+  BigInt unwind = (it == state.loop_iterations.end()) ? 0 : it->second;
+  if(unwind + 1 < ex_state.max_unwind)
+    return;
+
+  // Resuming an interleaving would mean exploring the others again from this
+  // point; only sequential exploration is resumed.
+  if(execution_states.size() != 1 || ex_state.threads_state.size() != 1)
+  {
+    k_step_checkpoint_invalid = true;
+    return;
+  }
+
+  k_step_checkpoint = ex_state.clone();
+}
+
+void reachability_treet::invalidate_k_step_checkpoint()
+{
+  if(k_step_checkpoint == nullptr)
+    k_step_checkpoint_invalid = true;
+}
+
+bool reachability_treet::resume_from_k_step_checkpoint(const BigInt &k_step)
+{
+  if(k_step_checkpoint == nullptr)
+    return false;
+
+  // Freeing the explored state pops its context, discarding every SSA step
+  // and solver assertion generated after the checkpoint was taken.
+  execution_states.clear();
+  execution_states.push_back(std::move(k_step_checkpoint));
+  k_step_checkpoint_invalid = false;
+
+  cur_state_it = execution_states.begin();
+  has_complete_formula = false;
+
+  get_cur_state().max_unwind = k_step;
+  return true;
+}
+
 std::shared_ptr<goto_symext::symex_resultt>
 reachability_treet::generate_schedule_formula()
 {
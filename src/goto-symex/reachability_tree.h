@@ -18,9 +18,9 @@ Author: Lucas Cordeiro, lcc08r@ecs.soton.ac.uk
 #include <iostream>
 #include <unordered_map>
 #include <unordered_set>
-#include <util/crypto_hash.h>
 #include <util/message.h>
 #include <util/options.h>
+#include <util/state_hash.h>
 
 /**
  *  Class to explore states reachable through threading.
@@ -165,6 +165,12 @@ public:
    */
   void update_hash_collision_set();
 
+  /** Size of the set of state hashes, and how often lookups collided */
+  std::string state_hash_stats() const
+  {
+    return hit_hashes.stats();
+  }
+
   /**
    *  Perform context switch operation triggered elsewhere.
    *  The analyse_* functions make a decision on whether or not to take a
@@ -250,6 +256,33 @@ public:
    */
   bool setup_next_formula();
 
+  /**
+   *  Take a k-step checkpoint, if this is the first bounded loop to exceed.
+   *  Called by --incremental-k-step symex before a backwards goto is
+   *  executed. If the goto is about to hit the global unwinding bound, and no
+   *  earlier decision in this run depended on that bound, the current
+   *  execution_statet is cloned. With --smt-during-symex the clone pushes a
+   *  solver context, so everything up to here stays encoded in the solver.
+   */
+  void save_k_step_checkpoint();
+
+  /**
+   *  Mark the current run as not resumable from a k-step checkpoint.
+   *  Used when something depending on the unwinding bound other than a
+   *  checkpointed loop was hit first, such as a recursion bound.
+   */
+  void invalidate_k_step_checkpoint();
+
+  /**
+   *  Continue exploring from the k-step checkpoint with a larger bound.
+   *  Discards the explored state, popping everything symex and the solver did
+   *  past the checkpoint, and makes the checkpoint the current state. Only
+   *  the extra unwindings then need to be symbolically executed.
+   *  @param k_step New global unwinding bound.
+   *  @return False if there is no checkpoint to resume from.
+   */
+  bool resume_from_k_step_checkpoint(const BigInt &k_step);
+
   /**
    *  Class recording a reachability checkpoint.
    *  Currently likely broken; but this originally redorced a particular trace
@@ -367,7 +400,7 @@ protected:
   /** Whether partial-order-reduction is enabled */
   bool por;
   /** Set of state hashes we've discovered */
-  std::set<crypto_hash> hit_hashes;
+  state_hash_sett hit_hashes;
   /** Message handler reference. */
   message_handlert &message_handler;
   /** Flag as to whether we're picking interleaving directions explicitly.
@@ -377,6 +410,10 @@ protected:
   bool round_robin;
   /** Are we using the --schedule scheduling method? */
   bool schedule;
+  /** State saved before the first loop that hit the unwinding bound */
+  std::shared_ptr<execution_statet> k_step_checkpoint;
+  /** Whether this run can no longer be resumed from a checkpoint */
+  bool k_step_checkpoint_invalid;
 
   /* Map to store the expression and thread ID,
    * which that expression belongs to. */
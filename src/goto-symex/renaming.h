@@ -2,11 +2,11 @@
 #define _GOTO_SYMEX_RENAMING_H_
 
 #include <boost/functional/hash.hpp>
-#include <util/crypto_hash.h>
 #include <util/expr_util.h>
 #include <util/guard.h>
 #include <util/i2string.h>
 #include <util/irep2_expr.h>
+#include <util/persistent_map.h>
 #include <util/std_expr.h>
 
 namespace renaming
@@ -263,6 +263,26 @@ public:
     }
   }
 
+  /** Collect the variables numbered differently here and in ref, which
+   *  should have forked from the same state: variables neither of them has
+   *  assigned to since aren't visited at all. Variables missing from either
+   *  are left out. */
+  void get_changed_variables(
+    const level2t &ref,
+    std::vector<name_record> &vars) const
+  {
+    current_names.diff(
+      ref.current_names,
+      [&vars](
+        const current_namest::value_type *mine,
+        const current_namest::value_type *theirs) {
+        if(
+          mine != nullptr && theirs != nullptr &&
+          mine->second.count != theirs->second.count)
+          vars.push_back(mine->first);
+      });
+  }
+
   unsigned current_number(const expr2tc &sym) const;
   unsigned current_number(const name_record &rec) const;
 
@@ -283,11 +303,11 @@ public:
 
   friend void build_goto_symex_classes();
   // Repeat of the above ignored friend directive.
-  typedef std::unordered_map<name_record, valuet, name_rec_hash> current_namest;
+  /** Persistent, so that cloning for a branch shares every entry until one
+   *  side assigns to it. */
+  typedef persistent_mapt<name_record, valuet, name_rec_hash> current_namest;
 
   current_namest current_names;
-  typedef std::map<const expr2tc, crypto_hash> current_state_hashest;
-  current_state_hashest current_hashes;
 };
 
 } // namespace renaming
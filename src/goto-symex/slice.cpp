@@ -12,7 +12,17 @@ symex_slicet::symex_slicet(bool assume)
   : ignored(0),
     slice_assumes(assume),
     add_to_deps([this](const symbol2t &s) -> bool {
-      return depends.insert(s.get_symbol_name()).second;
+      unsigned int num = numbering.number(s);
+      if(num >= depends.size())
+        depends.resize(std::max(num + 1, 2 * (unsigned int)depends.size()));
+      if(depends[num])
+        return false;
+      depends[num] = true;
+      return true;
+    }),
+    check_in_deps([this](const symbol2t &s) -> bool {
+      unsigned int num = numbering.find(s);
+      return num < depends.size() && depends[num];
     })
 {
 }
@@ -83,10 +93,6 @@ void symex_slicet::slice(symex_target_equationt::SSA_stept &SSA_step)
 
 void symex_slicet::slice_assume(symex_target_equationt::SSA_stept &SSA_step)
 {
-  auto check_in_deps = [this](const symbol2t &s) -> bool {
-    return depends.find(s.get_symbol_name()) != depends.end();
-  };
-
   if(!get_symbols(SSA_step.cond, check_in_deps))
   {
     // we don't really need it
@@ -105,10 +111,6 @@ void symex_slicet::slice_assignment(symex_target_equationt::SSA_stept &SSA_step)
 {
   assert(is_symbol2t(SSA_step.lhs));
 
-  auto check_in_deps = [this](const symbol2t &s) -> bool {
-    return depends.find(s.get_symbol_name()) != depends.end();
-  };
-
   if(!get_symbols(SSA_step.lhs, check_in_deps))
   {
     // we don't really need it
@@ -122,7 +124,9 @@ void symex_slicet::slice_assignment(symex_target_equationt::SSA_stept &SSA_step)
 
     // Remove this symbol as we won't be seeing any references to it further
     // into the history.
-    depends.erase(to_symbol2t(SSA_step.lhs).get_symbol_name());
+    unsigned int num = numbering.find(to_symbol2t(SSA_step.lhs));
+    if(num < depends.size())
+      depends[num] = false;
   }
 }
 
@@ -130,10 +134,6 @@ void symex_slicet::slice_renumber(symex_target_equationt::SSA_stept &SSA_step)
 {
   assert(is_symbol2t(SSA_step.lhs));
 
-  auto check_in_deps = [this](const symbol2t &s) -> bool {
-    return depends.find(s.get_symbol_name()) != depends.end();
-  };
-
   if(!get_symbols(SSA_step.lhs, check_in_deps))
   {
     // we don't really need it
@@ -144,6 +144,167 @@ void symex_slicet::slice_renumber(symex_target_equationt::SSA_stept &SSA_step)
   // Don't collect the symbol; this insn has no effect on dependencies.
 }
 
+claim_slicet::claim_slicet(const symex_target_equationt &eq, bool assume)
+  : slice_assumes(assume)
+{
+  steps.reserve(eq.SSA_steps.size());
+  for(auto const &SSA_step : eq.SSA_steps)
+  {
+    unsigned int num = steps.size();
+    steps.push_back(stept{SSA_step.type, SSA_step.ignore, {}, {}});
+    stept &step = steps.back();
+    if(SSA_step.ignore)
+      continue;
+
+    switch(SSA_step.type)
+    {
+    case goto_trace_stept::ASSIGNMENT:
+      collect(SSA_step.guard, step.reads);
+      collect(SSA_step.rhs, step.reads);
+      defs[symbol_number(to_symbol2t(SSA_step.lhs))].push_back(num);
+      break;
+
+    case goto_trace_stept::RENUMBER:
+      // Kept for its symbol, but like in symex_slicet, it adds no
+      // dependencies of its own
+      defs[symbol_number(to_symbol2t(SSA_step.lhs))].push_back(num);
+      break;
+
+    case goto_trace_stept::ASSUME:
+      collect(SSA_step.cond, step.triggers);
+      /* fallthrough */
+
+    case goto_trace_stept::ASSERT:
+      collect(SSA_step.guard, step.reads);
+      collect(SSA_step.cond, step.reads);
+      break;
+
+    default:
+      break;
+    }
+  }
+}
+
+unsigned int claim_slicet::symbol_number(const symbol2t &sym)
+{
+  unsigned int num = numbering.number(sym);
+  if(num == defs.size())
+    defs.emplace_back();
+  return num;
+}
+
+void claim_slicet::collect(
+  const expr2tc &expr,
+  std::vector<unsigned int> &syms)
+{
+  if(is_nil_expr(expr))
+    return;
+
+  if(is_symbol2t(expr))
+  {
+    syms.push_back(symbol_number(to_symbol2t(expr)));
+    return;
+  }
+
+  expr->foreach_operand(
+    [this, &syms](const expr2tc &e) { collect(e, syms); });
+}
+
+std::vector<bool>
+claim_slicet::cone(const std::vector<unsigned int> &claim) const
+{
+  std::vector<bool> keep(steps.size(), false);
+  std::vector<bool> seen(defs.size(), false);
+  std::vector<unsigned int> worklist;
+
+  unsigned int end = 0;
+  for(auto const &num : claim)
+    end = std::max(end, num + 1);
+
+  auto add_step = [&](unsigned int num) {
+    if(keep[num])
+      return;
+    keep[num] = true;
+    worklist.insert(
+      worklist.end(), steps[num].reads.begin(), steps[num].reads.end());
+  };
+
+  for(auto const &num : claim)
+    add_step(num);
+
+  // Outputs are never sliced away, and neither are assumptions unless asked
+  for(unsigned int i = 0; i < end; i++)
+  {
+    const stept &step = steps[i];
+    if(step.ignore)
+      continue;
+
+    if(
+      step.type == goto_trace_stept::OUTPUT ||
+      (step.type == goto_trace_stept::ASSUME && !slice_assumes))
+      add_step(i);
+  }
+
+  bool changed = true;
+  while(changed)
+  {
+    while(!worklist.empty())
+    {
+      unsigned int sym = worklist.back();
+      worklist.pop_back();
+      if(seen[sym])
+        continue;
+
+      seen[sym] = true;
+      for(auto const &def : defs[sym])
+        if(def < end)
+          add_step(def);
+    }
+
+    // An assumption is needed once its condition mentions anything in the
+    // cone, which can in turn pull more into it
+    changed = false;
+    if(!slice_assumes)
+      break;
+
+    for(unsigned int i = 0; i < end; i++)
+    {
+      const stept &step = steps[i];
+      if(keep[i] || step.ignore || step.type != goto_trace_stept::ASSUME)
+        continue;
+
+      for(auto const &sym : step.triggers)
+      {
+        if(seen[sym])
+        {
+          add_step(i);
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+
+  return keep;
+}
+
+unsigned int
+claim_slicet::apply(symex_target_equationt &eq, const std::vector<bool> &cone)
+{
+  assert(cone.size() == eq.SSA_steps.size());
+
+  unsigned int i = 0, kept = 0;
+  for(auto &SSA_step : eq.SSA_steps)
+  {
+    if(!cone[i++])
+      SSA_step.ignore = true;
+    else if(!SSA_step.ignore)
+      kept++;
+  }
+
+  return kept;
+}
+
 BigInt slice(std::shared_ptr<symex_target_equationt> &eq, bool slice_assumes)
 {
   symex_slicet symex_slice(slice_assumes);
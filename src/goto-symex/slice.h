@@ -11,24 +11,54 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <goto-symex/renaming.h>
 #include <goto-symex/symex_target_equation.h>
-#include <unordered_set>
+#include <unordered_map>
+#include <vector>
 
 BigInt slice(std::shared_ptr<symex_target_equationt> &eq, bool slice_assume);
 BigInt simple_slice(std::shared_ptr<symex_target_equationt> &eq);
 
+/** Numbers renamed symbols densely, in the order they are first seen, so
+ *  that sets of them can be bit vectors */
+class symbol_numberingt
+{
+public:
+  unsigned int number(const symbol2t &sym)
+  {
+    return numbers.emplace(sym.get_symbol_key(), numbers.size()).first->second;
+  }
+
+  /** @return The symbol's number, or size() if it has none yet */
+  unsigned int find(const symbol2t &sym) const
+  {
+    auto it = numbers.find(sym.get_symbol_key());
+    return it == numbers.end() ? size() : it->second;
+  }
+
+  unsigned int size() const
+  {
+    return numbers.size();
+  }
+
+protected:
+  std::unordered_map<symbol2t::keyt, unsigned int, symbol2t::key_hash>
+    numbers;
+};
+
 class symex_slicet
 {
 public:
   symex_slicet(bool assume);
   void slice(std::shared_ptr<symex_target_equationt> &eq);
 
-  typedef std::unordered_set<std::string> symbol_sett;
-  symbol_sett depends;
+  /** Symbols the steps seen so far depend on, by number */
+  symbol_numberingt numbering;
+  std::vector<bool> depends;
   BigInt ignored;
 
 protected:
   bool slice_assumes;
   std::function<bool(const symbol2t &)> add_to_deps;
+  std::function<bool(const symbol2t &)> check_in_deps;
 
   bool
   get_symbols(const expr2tc &expr, std::function<bool(const symbol2t &)> fn);
@@ -39,4 +69,43 @@ protected:
   void slice_renumber(symex_target_equationt::SSA_stept &SSA_step);
 };
 
+/** Cone of influence of individual claims. The dependencies between SSA
+ *  steps are collected once, after which the slice of any claim is a walk
+ *  over them, rather than another pass over the whole equation. */
+class claim_slicet
+{
+public:
+  claim_slicet(const symex_target_equationt &eq, bool assume);
+
+  /** Steps a claim depends on, by position in the equation. A claim is a set
+   *  of assertion steps; every other assertion is left out, as is anything
+   *  after the claim's last step. */
+  std::vector<bool> cone(const std::vector<unsigned int> &claim) const;
+
+  /** Ignore every step outside the cone, and count how many are kept */
+  static unsigned int
+  apply(symex_target_equationt &eq, const std::vector<bool> &cone);
+
+protected:
+  bool slice_assumes;
+
+  struct stept
+  {
+    goto_trace_stept::typet type;
+    bool ignore;
+    /** Symbols the step reads, including those in its guard */
+    std::vector<unsigned int> reads;
+    /** Symbols in an assumption's condition, which decide if it is kept */
+    std::vector<unsigned int> triggers;
+  };
+
+  std::vector<stept> steps;
+  /** Steps defining each symbol, by symbol number */
+  std::vector<std::vector<unsigned int>> defs;
+  symbol_numberingt numbering;
+
+  unsigned int symbol_number(const symbol2t &sym);
+  void collect(const expr2tc &expr, std::vector<unsigned int> &syms);
+};
+
 #endif
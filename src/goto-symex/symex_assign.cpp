@@ -40,6 +40,12 @@ goto_symext::goto_symext(
     last_throw(nullptr),
     inside_unexpected(false),
     no_return_value_opt(options.get_bool_option("no-return-value-opt")),
+    function_summaries(
+      options.get_bool_option("function-summaries")
+        ? std::make_shared<function_summariest>()
+        : nullptr),
+    symbol_types(
+      std::make_shared<std::unordered_map<irep_idt, type2tc, irep_id_hash>>()),
     stack_limit(atol(options.get_option("stack-limit").c_str())),
     depth_limit(atol(options.get_option("depth").c_str())),
     break_insn(atol(options.get_option("break-at").c_str())),
@@ -51,7 +57,8 @@ goto_symext::goto_symext(
     k_induction(options.get_bool_option("k-induction")),
     base_case(options.get_bool_option("base-case")),
     forward_condition(options.get_bool_option("forward-condition")),
-    inductive_step(options.get_bool_option("inductive-step"))
+    inductive_step(options.get_bool_option("inductive-step")),
+    incremental_k_step(options.get_bool_option("incremental-k-step"))
 {
   const std::string &set = options.get_option("unwindset");
   unsigned int length = set.length();
@@ -112,7 +119,10 @@ goto_symext &goto_symext::operator=(const goto_symext &sym)
   base_case = sym.base_case;
   forward_condition = sym.forward_condition;
   inductive_step = sym.inductive_step;
+  incremental_k_step = sym.incremental_k_step;
   first_loop = sym.first_loop;
+  function_summaries = sym.function_summaries;
+  symbol_types = sym.symbol_types;
 
   valid_ptr_arr_name = sym.valid_ptr_arr_name;
   alloc_size_arr_name = sym.alloc_size_arr_name;
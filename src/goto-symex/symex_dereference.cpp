@@ -12,6 +12,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <pointer-analysis/dereference.h>
 #include <util/irep2.h>
 #include <util/migrate.h>
+#include <util/phase_stats.h>
 
 void symex_dereference_statet::dereference_failure(
   const std::string &property [[gnu::unused]],
@@ -53,6 +54,8 @@ void symex_dereference_statet::get_value_set(
   value_setst::valuest &value_set)
 {
   state.value_set.get_value_set(expr, value_set);
+  phase_statst::count("symex.value_set_entries", value_set.size());
+  phase_statst::maximum("symex.value_set_max", value_set.size());
 }
 
 void symex_dereference_statet::rename(expr2tc &expr)
@@ -111,6 +114,9 @@ bool symex_dereference_statet::is_live_variable(const expr2tc &symbol)
 
 void goto_symext::dereference(expr2tc &expr, dereferencet::modet mode)
 {
+  phase_timert deref_phase("symex.deref", false);
+  phase_statst::count("symex.derefs");
+
   symex_dereference_statet symex_dereference_state(*this, *cur_state);
 
   dereferencet dereference(ns, new_context, options, symex_dereference_state);
@@ -11,6 +11,7 @@
 #include <cassert>
 #include <goto-symex/execution_state.h>
 #include <goto-symex/goto_symex.h>
+#include <goto-symex/reachability_tree.h>
 #include <langapi/language_util.h>
 #include <util/arith_tools.h>
 #include <util/base_type.h>
@@ -217,6 +218,14 @@ void goto_symext::symex_function_call_code(const expr2tc &expr)
     }
     else
     {
+      if(incremental_k_step)
+      {
+        auto rte =
+          std::dynamic_pointer_cast<runtime_encoded_equationt>(target);
+        rte->unwinding_check(cur_state->guard.as_expr());
+        art1->invalidate_k_step_checkpoint();
+      }
+
       // Add an unwinding assumption.
       expr2tc now_guard = cur_state->guard.as_expr();
       not2tc not_now(now_guard);
@@ -245,6 +254,11 @@ void goto_symext::symex_function_call_code(const expr2tc &expr)
     return;
   }
 
+  if(
+    function_summaries &&
+    symex_function_summary(call, identifier, goto_function))
+    return;
+
   // read the arguments -- before the locality renaming
   std::vector<expr2tc> arguments = call.operands;
   for(auto &argument : arguments)
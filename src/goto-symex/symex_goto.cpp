@@ -7,6 +7,7 @@
 
 \*******************************************************************/
 
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <goto-symex/goto_symex.h>
@@ -18,6 +19,7 @@
 #include <util/expr_util.h>
 #include <util/irep2.h>
 #include <util/migrate.h>
+#include <util/phase_stats.h>
 #include <util/prefix.h>
 #include <util/std_expr.h>
 
@@ -261,7 +263,9 @@ void goto_symext::merge_gotos()
     return; // nothing to do
 
   // we need to merge
+  phase_timert merge_phase("symex.merge", false);
   statet::goto_state_listt &state_list = state_map_it->second;
+  phase_statst::count("symex.merges", state_list.size());
 
   for(auto list_it = state_list.rbegin(); list_it != state_list.rend();
       list_it++)
@@ -300,8 +304,20 @@ void goto_symext::merge_locality(const statet::goto_statet &src)
     return;
   }
 
-  cur_state->top().local_variables.insert(
-    src.local_variables.begin(), src.local_variables.end());
+  // Only variables declared since the fork can be missing here
+  auto &local_variables = cur_state->top().local_variables;
+  std::vector<renaming::level2t::name_record> declared;
+  local_variables.diff(
+    src.local_variables,
+    [&declared](
+      const renaming::level2t::name_record *mine,
+      const renaming::level2t::name_record *theirs) {
+      if(mine == nullptr)
+        declared.push_back(*theirs);
+    });
+
+  for(auto const &it : declared)
+    local_variables.insert(it);
 }
 
 void goto_symext::merge_value_sets(const statet::goto_statet &src)
@@ -320,12 +336,10 @@ void goto_symext::phi_function(const statet::goto_statet &goto_state)
   if(goto_state.guard.is_false() && cur_state->guard.is_false())
     return;
 
-  // go over all variables to see what changed
-  std::set<renaming::level2t::name_record> variables;
-  cur_state->level2.get_variables(variables);
-
-  std::set<renaming::level2t::name_record> goto_variables;
-  goto_state.level2.get_variables(goto_variables);
+  // go over the variables that changed on either side, in a stable order
+  std::vector<renaming::level2t::name_record> variables;
+  cur_state->level2.get_changed_variables(goto_state.level2, variables);
+  std::sort(variables.begin(), variables.end());
 
   guardt tmp_guard;
   if(
@@ -340,28 +354,15 @@ void goto_symext::phi_function(const statet::goto_statet &goto_state)
 
   for(const auto &variable : variables)
   {
-    if(
-      goto_state.level2.current_number(variable) ==
-      cur_state->level2.current_number(variable))
-      continue; // not changed
-
     if(variable.base_name == guard_identifier_s)
       continue; // just a guard
 
     if(has_prefix(variable.base_name.as_string(), "symex::invalid_object"))
       continue;
 
-    // If the variable was deleted in this branch, don't create an assignment
-    // for it
-    if(goto_variables.find(variable) == goto_variables.end())
-      continue;
-
     // changed!
     const symbolt &symbol = ns.lookup(variable.base_name);
-
-    type2tc type;
-    typet old_type = symbol.type;
-    migrate_type(symbol.type, type);
+    const type2tc &type = get_symbol_type(symbol);
 
     expr2tc cur_state_rhs = symbol2tc(type, symbol.id);
     renaming::level2t::rename_to_record(cur_state_rhs, variable);
@@ -386,8 +387,7 @@ void goto_symext::phi_function(const statet::goto_statet &goto_state)
       simplify(rhs);
     }
 
-    expr2tc lhs;
-    migrate_expr(symbol_expr(symbol), lhs);
+    expr2tc lhs = symbol2tc(type, symbol.id);
     expr2tc new_lhs = lhs;
 
     // Again, specifiy which l1 data object we're going to make the assignment
@@ -410,6 +410,17 @@ void goto_symext::phi_function(const statet::goto_statet &goto_state)
   }
 }
 
+const type2tc &goto_symext::get_symbol_type(const symbolt &symbol)
+{
+  auto it = symbol_types->find(symbol.id);
+  if(it != symbol_types->end())
+    return it->second;
+
+  type2tc type;
+  migrate_type(symbol.type, type);
+  return symbol_types->emplace(symbol.id, type).first->second;
+}
+
 void goto_symext::loop_bound_exceeded(const expr2tc &guard)
 {
   if(partial_loops && !config.options.get_bool_option("termination"))
@@ -427,6 +438,14 @@ void goto_symext::loop_bound_exceeded(const expr2tc &guard)
   }
   else
   {
+    // Remember where execution would have continued, to be able to ask the
+    // forward condition on this very formula
+    if(incremental_k_step)
+    {
+      auto rte = std::dynamic_pointer_cast<runtime_encoded_equationt>(target);
+      rte->unwinding_check(and2tc(cur_state->guard.as_expr(), guard));
+    }
+
     // generate unwinding assumption, unless we permit partial loops
     expr2tc guarded_expr = negated_cond;
     cur_state->guard.guard_expr(guarded_expr);
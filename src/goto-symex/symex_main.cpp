@@ -19,6 +19,7 @@
 #include <util/expr_util.h>
 #include <util/irep2.h>
 #include <util/migrate.h>
+#include <util/phase_stats.h>
 #include <util/prefix.h>
 #include <util/pretty.h>
 #include <util/simplify_expr.h>
@@ -97,6 +98,12 @@ void goto_symext::symex_step(reachability_treet &art)
   assert(!cur_state->call_stack.empty());
 
   const goto_programt::instructiont &instruction = *cur_state->source.pc;
+  phase_statst::count("symex.steps");
+
+  // Checkpoint before this instruction has any effect, so that resuming with
+  // a larger bound executes it again
+  if(incremental_k_step && instruction.is_backwards_goto())
+    art.save_k_step_checkpoint();
 
   // depth exceeded?
   {
@@ -343,6 +350,8 @@ void goto_symext::run_intrinsic(
   reachability_treet &art,
   const std::string &symname)
 {
+  phase_timert builtin_phase("symex.builtin", false);
+
   if(symname == "c:@F@__ESBMC_yield")
   {
     intrinsic_yield(art);
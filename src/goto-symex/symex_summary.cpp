@@ -0,0 +1,369 @@
+/*******************************************************************\
+
+   Module: Function summaries for symbolic execution
+
+\*******************************************************************/
+
+#include <functional>
+#include <goto-symex/execution_state.h>
+#include <goto-symex/goto_symex.h>
+#include <goto-symex/reachability_tree.h>
+#include <util/base_type.h>
+#include <util/irep2_utils.h>
+
+namespace
+{
+/** Values of the callee's locals along one path, over its parameters and
+ *  the globals it reads. The empty identifier holds the return value. */
+typedef std::map<irep_idt, expr2tc> summary_envt;
+
+struct summary_statet
+{
+  expr2tc guard;
+  summary_envt env;
+};
+
+/** Computes the return value of a loop free callee that only writes its own
+ *  locals, by evaluating its body once over all paths. */
+class function_summarizert
+{
+public:
+  function_summarizert(const namespacet &_ns, const goto_functiont &_function)
+    : ns(_ns), function(_function), reads_globals(false)
+  {
+  }
+
+  bool summarize(goto_symext::function_summaryt &summary);
+
+protected:
+  bool eval(expr2tc &expr, const summary_envt &env);
+  summary_statet merge(const std::list<summary_statet> &states) const;
+  static expr2tc and_guard(const expr2tc &guard, const expr2tc &cond);
+
+  const namespacet &ns;
+  const goto_functiont &function;
+  std::set<irep_idt> locals;
+  bool reads_globals;
+};
+} // namespace
+
+expr2tc
+function_summarizert::and_guard(const expr2tc &guard, const expr2tc &cond)
+{
+  if(is_true(guard))
+    return cond;
+  if(is_true(cond))
+    return guard;
+  if(is_false(guard) || is_false(cond))
+    return gen_false_expr();
+  return and2tc(guard, cond);
+}
+
+bool function_summarizert::eval(expr2tc &expr, const summary_envt &env)
+{
+  if(is_nil_expr(expr))
+    return true;
+
+  // Anything that touches memory, or has effects of its own, would need the
+  // full symbolic execution machinery
+  if(
+    is_dereference2t(expr) || is_address_of2t(expr) || is_sideeffect2t(expr) ||
+    is_code_type(expr))
+    return false;
+
+  if(is_symbol2t(expr))
+  {
+    const irep_idt &id = to_symbol2t(expr).thename;
+    if(locals.count(id))
+    {
+      summary_envt::const_iterator it = env.find(id);
+      if(it == env.end())
+        return false;
+
+      expr = it->second;
+      return true;
+    }
+
+    const symbolt *symbol;
+    if(ns.lookup(id, symbol) || !symbol->static_lifetime)
+      return false;
+
+    // Globals are left alone, and get their value at the call site
+    reads_globals = true;
+    return true;
+  }
+
+  bool ok = true;
+  expr->Foreach_operand([this, &ok, &env](expr2tc &e) {
+    if(ok)
+      ok = eval(e, env);
+  });
+  return ok;
+}
+
+summary_statet
+function_summarizert::merge(const std::list<summary_statet> &states) const
+{
+  assert(!states.empty());
+  summary_statet merged = states.front();
+
+  for(auto it = std::next(states.begin()); it != states.end(); it++)
+  {
+    if(is_true(merged.guard) || is_true(it->guard))
+      merged.guard = gen_true_expr();
+    else
+      merged.guard = or2tc(merged.guard, it->guard);
+
+    // Incoming paths are disjoint, as the body has no loops
+    for(auto var = merged.env.begin(); var != merged.env.end();)
+    {
+      summary_envt::const_iterator other = it->env.find(var->first);
+      if(other == it->env.end())
+      {
+        // Undefined along this path, so unusable after the merge
+        var = merged.env.erase(var);
+        continue;
+      }
+
+      if(other->second != var->second)
+        var->second =
+          if2tc(var->second->type, it->guard, other->second, var->second);
+      var++;
+    }
+  }
+
+  return merged;
+}
+
+bool function_summarizert::summarize(goto_symext::function_summaryt &summary)
+{
+  const goto_programt &body = function.body;
+
+  type2tc tmp_type;
+  migrate_type(function.type, tmp_type);
+  const code_type2t &type = to_code_type(tmp_type);
+  if(type.ellipsis)
+    return false;
+
+  summary_statet cur;
+  cur.guard = gen_true_expr();
+
+  for(unsigned int i = 0; i < type.arguments.size(); i++)
+  {
+    const irep_idt &id = type.argument_names[i];
+    if(id == "")
+      return false;
+
+    locals.insert(id);
+    cur.env[id] = symbol2tc(type.arguments[i], id);
+    summary.parameters.push_back(id);
+  }
+
+  for(auto const &instr : body.instructions)
+    if(instr.is_decl())
+      locals.insert(to_code_decl2t(instr.code).value);
+
+  // States waiting at a jump target, by location number
+  std::map<unsigned int, std::list<summary_statet>> pending;
+  bool reachable = true;
+
+  for(auto const &instr : body.instructions)
+  {
+    auto p = pending.find(instr.location_number);
+    if(p != pending.end())
+    {
+      if(reachable)
+        p->second.push_back(cur);
+      cur = merge(p->second);
+      reachable = true;
+      pending.erase(p);
+    }
+
+    if(!reachable)
+      continue;
+
+    switch(instr.type)
+    {
+    case SKIP:
+    case LOCATION:
+      break;
+
+    case DECL:
+      cur.env.erase(to_code_decl2t(instr.code).value);
+      break;
+
+    case DEAD:
+      cur.env.erase(to_code_dead2t(instr.code).value);
+      break;
+
+    case ASSIGN:
+    {
+      const code_assign2t &assign = to_code_assign2t(instr.code);
+      if(!is_symbol2t(assign.target))
+        return false;
+
+      const irep_idt &id = to_symbol2t(assign.target).thename;
+      if(!locals.count(id))
+        return false;
+
+      expr2tc rhs = assign.source;
+      if(!eval(rhs, cur.env))
+        return false;
+
+      cur.env[id] = rhs;
+      break;
+    }
+
+    case RETURN:
+    {
+      const code_return2t &ret = to_code_return2t(instr.code);
+      if(!is_nil_expr(ret.operand))
+      {
+        expr2tc value = ret.operand;
+        if(!eval(value, cur.env))
+          return false;
+        cur.env[irep_idt()] = value;
+      }
+
+      pending[body.instructions.back().location_number].push_back(cur);
+      reachable = false;
+      break;
+    }
+
+    case GOTO:
+    {
+      if(instr.is_backwards_goto())
+        return false;
+
+      expr2tc cond = instr.guard;
+      if(!eval(cond, cur.env))
+        return false;
+
+      if(is_false(cond))
+        break;
+
+      for(auto const &target : instr.targets)
+      {
+        summary_statet taken = cur;
+        taken.guard = and_guard(cur.guard, cond);
+        pending[target->location_number].push_back(taken);
+      }
+
+      if(is_true(cond))
+      {
+        reachable = false;
+        break;
+      }
+
+      expr2tc not_cond = cond;
+      make_not(not_cond);
+      cur.guard = and_guard(cur.guard, not_cond);
+      break;
+    }
+
+    case END_FUNCTION:
+    {
+      summary_envt::const_iterator it = cur.env.find(irep_idt());
+      if(it != cur.env.end())
+        summary.value = it->second;
+      break;
+    }
+
+    default:
+      // Assertions, assumptions, calls, threads, exceptions...
+      return false;
+    }
+  }
+
+  if(!reachable || !pending.empty())
+    return false;
+
+  summary.reads_globals = reads_globals;
+  return true;
+}
+
+bool goto_symext::symex_function_summary(
+  const code_function_call2t &call,
+  const irep_idt &identifier,
+  const goto_functiont &goto_function)
+{
+  auto &summaries = function_summaries->summaries;
+  auto it = summaries.find(identifier);
+  if(it == summaries.end())
+  {
+    function_summaryt summary;
+    function_summarizert summarizer(ns, goto_function);
+    summary.valid = summarizer.summarize(summary);
+    it = summaries.emplace(identifier, summary).first;
+  }
+
+  const function_summaryt &summary = it->second;
+  if(!summary.valid)
+    return false;
+
+  // The callee's reads would no longer be interleaved with other threads
+  if(summary.reads_globals && art1->get_cur_state().threads_state.size() > 1)
+    return false;
+
+  if(!is_nil_expr(call.ret) && is_nil_expr(summary.value))
+    return false;
+
+  if(call.operands.size() != summary.parameters.size())
+    return false;
+
+  type2tc tmp_type;
+  migrate_type(goto_function.type, tmp_type);
+  const code_type2t &type = to_code_type(tmp_type);
+
+  // Bind the actual arguments, in the caller's frame, to the parameters
+  std::map<irep_idt, expr2tc> arguments;
+  for(unsigned int i = 0; i < summary.parameters.size(); i++)
+  {
+    expr2tc arg = call.operands[i];
+    if(is_nil_expr(arg))
+      return false;
+
+    const type2tc &arg_type = type.arguments[i];
+    if(!base_type_eq(arg_type, arg->type, ns))
+    {
+      if(
+        !(is_number_type(arg_type) || is_pointer_type(arg_type)) ||
+        !(is_number_type(arg->type) || is_pointer_type(arg->type)))
+        return false;
+
+      arg = typecast2tc(arg_type, arg);
+    }
+
+    arguments[summary.parameters[i]] = arg;
+  }
+
+  if(!is_nil_expr(call.ret))
+  {
+    std::function<void(expr2tc &)> instantiate = [&](expr2tc &e) {
+      if(is_nil_expr(e))
+        return;
+
+      if(is_symbol2t(e))
+      {
+        auto arg = arguments.find(to_symbol2t(e).thename);
+        if(arg != arguments.end())
+          e = arg->second;
+        return;
+      }
+
+      e->Foreach_operand(instantiate);
+    };
+
+    expr2tc value = summary.value;
+    instantiate(value);
+
+    if(!base_type_eq(call.ret->type, value->type, ns))
+      value = typecast2tc(call.ret->type, value);
+
+    symex_assign(code_assign2tc(call.ret, value));
+  }
+
+  function_summaries->instantiated++;
+  cur_state->source.pc++;
+  return true;
+}
@@ -16,3 +16,12 @@ bool operator<(const symex_targett::sourcet &a, const symex_targett::sourcet &b)
     return false;
   return a.pc < b.pc;
 }
+
+std::vector<stack_framet> stack_trace_frames(const stack_tracet &trace)
+{
+  std::vector<stack_framet> frames;
+  for(const stack_frame_nodet *n = trace.get(); n != nullptr;
+      n = n->parent.get())
+    frames.push_back(n->frame);
+  return frames;
+}
@@ -10,6 +10,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #define CPROVER_GOTO_SYMEX_SYMEX_TARGET_H
 
 #include <goto-programs/goto_program.h>
+#include <memory>
 #include <util/expr.h>
 #include <util/guard.h>
 #include <util/irep2.h>
@@ -17,6 +18,10 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <vector>
 
 class stack_framet;
+class stack_frame_nodet;
+
+/** Shared, immutable call stack; null for the top level call. */
+typedef std::shared_ptr<const stack_frame_nodet> stack_tracet;
 
 class symex_targett
 {
@@ -49,7 +54,7 @@ public:
     const expr2tc &original_lhs,
     const expr2tc &rhs,
     const sourcet &source,
-    std::vector<stack_framet> stack_trace,
+    const stack_tracet &stack_trace,
     const bool hidden,
     unsigned loop_number) = 0;
 
@@ -74,7 +79,7 @@ public:
     const expr2tc &guard,
     const expr2tc &cond,
     const std::string &msg,
-    std::vector<stack_framet> stack_trace,
+    const stack_tracet &stack_trace,
     const sourcet &source,
     unsigned loop_number) = 0;
 
@@ -139,4 +144,22 @@ inline bool operator==(const stack_framet &a, const stack_framet &b)
   return a._cmp(b);
 }
 
+/** One function activation in a stack trace, linked to its caller. Every step
+ *  recorded within an activation points at the same node, and callees share
+ *  their caller's chain, so a trace costs one pointer per step. */
+class stack_frame_nodet
+{
+public:
+  stack_frame_nodet(const stack_framet &_frame, const stack_tracet &_parent)
+    : frame(_frame), parent(_parent)
+  {
+  }
+
+  stack_framet frame;
+  stack_tracet parent;
+};
+
+/** Materialise a stack trace, most recent call first */
+std::vector<stack_framet> stack_trace_frames(const stack_tracet &trace);
+
 #endif
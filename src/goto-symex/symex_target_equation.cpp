@@ -11,10 +11,12 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <goto-symex/goto_symex_state.h>
 #include <goto-symex/symex_target_equation.h>
 #include <langapi/language_util.h>
+#include <unordered_map>
 #include <util/expr_util.h>
 #include <util/i2string.h>
 #include <util/irep2.h>
 #include <util/migrate.h>
+#include <util/phase_stats.h>
 #include <util/std_expr.h>
 
 void symex_target_equationt::assignment(
@@ -23,7 +25,7 @@ void symex_target_equationt::assignment(
   const expr2tc &original_lhs,
   const expr2tc &rhs,
   const sourcet &source,
-  std::vector<stack_framet> stack_trace,
+  const stack_tracet &stack_trace,
   const bool hidden,
   unsigned loop_number)
 {
@@ -89,7 +91,7 @@ void symex_target_equationt::assertion(
   const expr2tc &guard,
   const expr2tc &cond,
   const std::string &msg,
-  std::vector<stack_framet> stack_trace,
+  const stack_tracet &stack_trace,
   const sourcet &source,
   unsigned loop_number)
 {
@@ -130,16 +132,56 @@ void symex_target_equationt::renumber(
 }
 
 void symex_target_equationt::convert(smt_convt &smt_conv)
+{
+  smt_convt::ast_vec assertions = convert_steps(smt_conv);
+
+  if(!assertions.empty())
+    smt_conv.assert_ast(
+      smt_conv.make_n_ary(&smt_conv, &smt_convt::mk_or, assertions));
+}
+
+smt_convt::ast_vec symex_target_equationt::convert_steps(smt_convt &smt_conv)
 {
   smt_convt::ast_vec assertions;
   smt_astt assumpt_ast = smt_conv.convert_ast(gen_true_expr());
 
+  // The breakdown costs a clock read per step, so is only kept when asked for
+  bool stats = phase_statst::enabled;
+  fine_timet last = stats ? current_time() : 0;
+
   for(auto &SSA_step : SSA_steps)
+  {
     convert_internal_step(smt_conv, assumpt_ast, assertions, SSA_step);
 
-  if(!assertions.empty())
-    smt_conv.assert_ast(
-      smt_conv.make_n_ary(&smt_conv, &smt_convt::mk_or, assertions));
+    if(!stats)
+      continue;
+
+    fine_timet now = current_time();
+    encoding_stats.steps++;
+    if(SSA_step.is_assignment())
+      encoding_stats.assignments += now - last;
+    else if(SSA_step.is_assert() || SSA_step.is_assume())
+      encoding_stats.properties += now - last;
+    else
+      encoding_stats.other += now - last;
+    last = now;
+  }
+
+  return assertions;
+}
+
+std::string symex_target_equationt::encoding_stats_text() const
+{
+  std::ostringstream str;
+  str << "Encoding breakdown: " << encoding_stats.steps
+      << " steps, with their guards; assignments ";
+  output_time(encoding_stats.assignments, str);
+  str << "s, assertions and assumptions ";
+  output_time(encoding_stats.properties, str);
+  str << "s, other ";
+  output_time(encoding_stats.other, str);
+  str << "s";
+  return str.str();
 }
 
 void symex_target_equationt::convert_internal_step(
@@ -329,7 +371,10 @@ operator<<(std::ostream &out, const symex_target_equationt &equation)
 
 void symex_target_equationt::check_for_duplicate_assigns() const
 {
-  std::map<std::string, unsigned int> countmap;
+  // Count by symbol key; names are only built for the symbols reported
+  std::unordered_map<symbol2t::keyt, unsigned int, symbol2t::key_hash>
+    countmap;
+  std::map<std::string, unsigned int> duplicates;
   unsigned int i = 0;
 
   for(const auto &SSA_step : SSA_steps)
@@ -340,23 +385,43 @@ void symex_target_equationt::check_for_duplicate_assigns() const
 
     const equality2t &ref = to_equality2t(SSA_step.cond);
     const symbol2t &sym = to_symbol2t(ref.side_1);
-    countmap[sym.get_symbol_name()]++;
+    unsigned int count = ++countmap[sym.get_symbol_key()];
+    if(count > 1)
+      duplicates[sym.get_symbol_name()] = count;
   }
 
-  for(std::map<std::string, unsigned int>::const_iterator it = countmap.begin();
-      it != countmap.end();
+  for(std::map<std::string, unsigned int>::const_iterator it =
+        duplicates.begin();
+      it != duplicates.end();
       it++)
   {
-    if(it->second != 1)
-    {
-      std::cerr << "Symbol \"" << it->first << "\" appears " << it->second
-                << " times" << std::endl;
-    }
+    std::cerr << "Symbol \"" << it->first << "\" appears " << it->second
+              << " times" << std::endl;
   }
 
   std::cerr << "Checked " << i << " insns" << std::endl;
 }
 
+unsigned int symex_target_equationt::release_sliced_steps()
+{
+  unsigned int released = 0;
+  for(auto &SSA_step : SSA_steps)
+  {
+    if(!SSA_step.ignore || !SSA_step.is_assignment())
+      continue;
+
+    SSA_step.guard = expr2tc();
+    SSA_step.lhs = expr2tc();
+    SSA_step.rhs = expr2tc();
+    SSA_step.original_lhs = expr2tc();
+    SSA_step.cond = expr2tc();
+    SSA_step.stack_trace.reset();
+    released++;
+  }
+
+  return released;
+}
+
 unsigned int symex_target_equationt::clear_assertions()
 {
   unsigned int num_asserts = 0;
@@ -378,9 +443,14 @@ unsigned int symex_target_equationt::clear_assertions()
 runtime_encoded_equationt::runtime_encoded_equationt(
   const namespacet &_ns,
   smt_convt &_conv)
-  : symex_target_equationt(_ns), conv(_conv)
+  : symex_target_equationt(_ns),
+    conv(_conv),
+    question_hits(0),
+    question_misses(0)
 {
   assert_vec_list.emplace_back();
+  unwind_vec_list.emplace_back();
+  question_cache.emplace_back();
   assumpt_chain.push_back(conv.convert_ast(gen_true_expr()));
   cvt_progress = SSA_steps.end();
 }
@@ -427,6 +497,8 @@ void runtime_encoded_equationt::push_ctx()
   // And push everything back.
   assumpt_chain.push_back(assumpt_chain.back());
   assert_vec_list.push_back(assert_vec_list.back());
+  unwind_vec_list.push_back(unwind_vec_list.back());
+  question_cache.emplace_back();
   scoped_end_points.push_back(cvt_progress);
   conv.push_ctx();
 }
@@ -444,6 +516,8 @@ void runtime_encoded_equationt::pop_ctx()
   conv.pop_ctx();
   scoped_end_points.pop_back();
   assert_vec_list.pop_back();
+  unwind_vec_list.pop_back();
+  question_cache.pop_back();
   assumpt_chain.pop_back();
 }
 
@@ -461,6 +535,17 @@ void runtime_encoded_equationt::convert(smt_convt &smt_conv)
       &smt_conv, &smt_convt::mk_or, assert_vec_list.back()));
 }
 
+void runtime_encoded_equationt::unwinding_check(const expr2tc &cond)
+{
+  // Everything up to this point needs to be in the solver, so that the
+  // assumption chain reflects the assumptions preceding the bound.
+  flush_latest_instructions();
+
+  assert(is_bool_type(cond));
+  unwind_vec_list.back().push_back(
+    conv.mk_and(assumpt_chain.back(), conv.convert_ast(cond)));
+}
+
 std::shared_ptr<symex_targett> runtime_encoded_equationt::clone() const
 {
   // Only permit cloning at the start of a run - there should never be any data
@@ -477,10 +562,63 @@ std::shared_ptr<symex_targett> runtime_encoded_equationt::clone() const
   return nthis;
 }
 
+bool runtime_encoded_equationt::lookup_question(
+  const expr2tc &question,
+  question_answert &ans) const
+{
+  // Every level still on the stack answered for a prefix of the current
+  // formula. Steps added since can't turn a definite answer around, short of
+  // making this point unreachable altogether, in which case it doesn't matter
+  // what we answer. Unknown answers only hold for the very same formula.
+  for(auto it = question_cache.rbegin(); it != question_cache.rend(); it++)
+  {
+    question_cachet::const_iterator a = it->find(question);
+    if(a == it->end())
+      continue;
+
+    if(
+      a->second.dual_unsat || !a->second.answer.is_unknown() ||
+      a->second.num_steps == SSA_steps.size())
+    {
+      ans = a->second;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+std::string runtime_encoded_equationt::question_cache_stats() const
+{
+  unsigned int asked = question_hits + question_misses;
+
+  std::ostringstream str;
+  str << "Solver question cache: " << question_hits << " of " << asked
+      << " questions answered from cache";
+  if(asked != 0)
+    str << " (" << (question_hits * 100) / asked << "%)";
+  return str.str();
+}
+
 tvt runtime_encoded_equationt::ask_solver_question(const expr2tc &question)
 {
   tvt final_res;
 
+  question_answert cached;
+  if(lookup_question(question, cached))
+  {
+    question_hits++;
+    if(cached.dual_unsat)
+      throw dual_unsat_exception();
+    return cached.answer;
+  }
+
+  question_misses++;
+  question_answert &ans = question_cache.back()[question];
+  ans.answer = tvt(tvt::TV_UNKNOWN);
+  ans.dual_unsat = false;
+  ans.num_steps = SSA_steps.size();
+
   // So - we have a formula, we want to work out whether it's true, false, or
   // unknown. Before doing anything, first push a context, as we'll need to
   // wipe some state afterwards.
@@ -537,11 +675,13 @@ tvt runtime_encoded_equationt::ask_solver_question(const expr2tc &question)
   else
   {
     pop_ctx();
+    ans.dual_unsat = true;
     throw dual_unsat_exception();
   }
 
   // We have our result; pop off the questions / formula we've asked.
   pop_ctx();
+  ans.answer = final_res;
 
   return final_res;
 }
@@ -18,9 +18,11 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <list>
 #include <map>
 #include <solvers/smt/smt_conv.h>
+#include <unordered_map>
 #include <util/config.h>
 #include <util/irep2.h>
 #include <util/namespace.h>
+#include <util/time_stopping.h>
 #include <vector>
 
 class symex_target_equationt : public symex_targett
@@ -33,6 +35,7 @@ public:
     debug_print = config.options.get_bool_option("symex-ssa-trace");
     ssa_trace = config.options.get_bool_option("ssa-trace");
     ssa_smt_trace = config.options.get_bool_option("ssa-smt-trace");
+    encoding_stats = encoding_statst{0, 0, 0, 0};
   }
 
   // assignment to a variable - must be symbol
@@ -43,7 +46,7 @@ public:
     const expr2tc &original_lhs,
     const expr2tc &rhs,
     const sourcet &source,
-    std::vector<stack_framet> stack_trace,
+    const stack_tracet &stack_trace,
     const bool hidden,
     unsigned loop_number) override;
 
@@ -68,7 +71,7 @@ public:
     const expr2tc &guard,
     const expr2tc &cond,
     const std::string &msg,
-    std::vector<stack_framet> stack_trace,
+    const stack_tracet &stack_trace,
     const sourcet &source,
     unsigned loop_number) override;
 
@@ -79,22 +82,38 @@ public:
     const sourcet &source) override;
 
   virtual void convert(smt_convt &smt_conv);
+  // encode all steps, returning the negated assertions instead of asserting
+  // their disjunction; each assertion's cond_ast implies its condition
+  smt_convt::ast_vec convert_steps(smt_convt &smt_conv);
   void convert_internal_step(
     smt_convt &smt_conv,
     smt_astt &assumpt_ast,
     smt_convt::ast_vec &assertions,
     SSA_stept &s);
 
+  /** Where encoding time went, by kind of step. Only collected with
+   *  --memstats or --profile-json. */
+  struct encoding_statst
+  {
+    unsigned int steps;
+    fine_timet assignments;
+    fine_timet properties;
+    fine_timet other;
+  };
+
+  encoding_statst encoding_stats;
+  std::string encoding_stats_text() const;
+
   class SSA_stept
   {
   public:
     sourcet source;
     goto_trace_stept::typet type;
 
-    // One stack trace recorded per function activation record. Valid for
-    // assignment and assert steps only. In reverse order (most recent in idx
-    // 0).
-    std::vector<stack_framet> stack_trace;
+    // Call stack at the time of the step, shared with the other steps of the
+    // same function activation. Valid for assignment and assert steps only.
+    // Use stack_trace_frames() to get the frames, most recent first.
+    stack_tracet stack_trace;
 
     bool is_assert() const
     {
@@ -128,10 +147,10 @@ public:
 
     // for ASSUME/ASSERT
     expr2tc cond;
-    std::string comment;
+    irep_idt comment;
 
     // for OUTPUT
-    std::string format_string;
+    irep_idt format_string;
     std::list<expr2tc> output_args;
 
     // for conversion
@@ -159,6 +178,11 @@ public:
     void dump() const;
   };
 
+  /** Drop what sliced away assignments hold. Nothing reads them once the
+   *  equation is encoded: traces skip steps whose guard isn't true.
+   *  @return Number of steps released. */
+  unsigned int release_sliced_steps();
+
   unsigned count_ignored_SSA_steps() const
   {
     unsigned i = 0;
@@ -230,11 +254,40 @@ public:
 
   tvt ask_solver_question(const expr2tc &question);
 
+  // hit rate of the cache of earlier answers to ask_solver_question
+  std::string question_cache_stats() const;
+
+  // record that an unwinding bound was hit while cond holds; kept apart from
+  // the assertions so the forward condition can be asked separately
+  void unwinding_check(const expr2tc &cond);
+
   smt_convt &conv;
   std::list<smt_convt::ast_vec> assert_vec_list;
+  std::list<smt_convt::ast_vec> unwind_vec_list;
   std::list<smt_astt> assumpt_chain;
   std::list<SSA_stepst::iterator> scoped_end_points;
   SSA_stepst::iterator cvt_progress;
+
+protected:
+  /** An earlier answer, and the number of steps in the formula it was given
+   *  for */
+  struct question_answert
+  {
+    tvt answer;
+    bool dual_unsat;
+    size_t num_steps;
+  };
+
+  typedef std::unordered_map<expr2tc, question_answert, irep2_hash>
+    question_cachet;
+
+  bool lookup_question(const expr2tc &question, question_answert &ans) const;
+
+  /** Answers recorded at each context level, dropped along with the level in
+   *  pop_ctx, as they may depend on steps that it discards. */
+  std::list<question_cachet> question_cache;
+  unsigned int question_hits;
+  unsigned int question_misses;
 };
 
 extern inline bool operator<(
@@ -6,12 +6,26 @@ Author: Daniel Kroening, kroening@cs.cmu.edu
 
 \*******************************************************************/
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <langapi/language_ui.h>
 #include <langapi/mode.h>
+#include <map>
 #include <memory>
+#include <sstream>
+#include <util/c_link.h>
 #include <util/i2string.h>
+#include <util/irep_serialization.h>
 #include <util/show_symbol_table.h>
+#include <util/symbol_serialization.h>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 static ui_message_handlert::uit get_ui_cmdline(const cmdlinet &cmdline)
 {
@@ -26,13 +40,30 @@ static ui_message_handlert::uit get_ui_cmdline(const cmdlinet &cmdline)
 }
 
 language_uit::language_uit(const cmdlinet &__cmdline)
-  : ui_message_handler(get_ui_cmdline(__cmdline)), _cmdline(__cmdline)
+  : ui_message_handler(get_ui_cmdline(__cmdline)),
+    _cmdline(__cmdline),
+    typechecked(false)
 {
   set_message_handler(&ui_message_handler);
 }
 
 bool language_uit::parse()
 {
+  // The parse trees only live in the worker processes
+  const std::string &jobs = config.options.get_option("parallel-frontend");
+  if(
+    jobs != "" && _cmdline.args.size() > 1 &&
+    !_cmdline.isset("parse-tree-too") && !_cmdline.isset("parse-tree-only"))
+  {
+    unsigned int num_jobs = atoi(jobs.c_str());
+#ifndef _WIN32
+    if(num_jobs == 0)
+      num_jobs = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+    if(num_jobs > 1)
+      return parse_parallel(num_jobs);
+  }
+
   for(const auto &arg : _cmdline.args)
   {
     if(parse(arg))
@@ -43,13 +74,36 @@ bool language_uit::parse()
 }
 
 bool language_uit::parse(const std::string &filename)
+{
+  language_filet *lf = add_file(filename);
+  if(lf == nullptr)
+    return true;
+
+  languaget &language = *lf->language;
+
+  status("Parsing", filename);
+
+  if(language.parse(filename, *get_message_handler()))
+  {
+    if(get_ui() == ui_message_handlert::PLAIN)
+      std::cerr << "PARSING ERROR" << std::endl;
+
+    return true;
+  }
+
+  lf->get_modules();
+
+  return false;
+}
+
+language_filet *language_uit::add_file(const std::string &filename)
 {
   int mode = get_mode_filename(filename);
 
   if(mode < 0)
   {
     error("failed to figure out type of file", filename);
-    return true;
+    return nullptr;
   }
 
   if(config.options.get_bool_option("old-frontend"))
@@ -60,7 +114,7 @@ bool language_uit::parse(const std::string &filename)
   if(!infile)
   {
     error("failed to open input file", filename);
-    return true;
+    return nullptr;
   }
 
   language_filet language_file;
@@ -72,25 +126,233 @@ bool language_uit::parse(const std::string &filename)
   language_filet &lf = result.first->second;
   lf.filename = filename;
   lf.language = mode_table[mode].new_language();
-  languaget &language = *lf.language;
 
-  status("Parsing", filename);
+  return &lf;
+}
 
-  if(language.parse(filename, *get_message_handler()))
+#ifndef _WIN32
+/** Reads all of a worker's temporary file, and closes it */
+static std::string read_and_close(FILE *f)
+{
+  std::string data;
+  if(f == nullptr)
+    return data;
+
+  rewind(f);
+  char buf[4096];
+  for(size_t n; (n = fread(buf, 1, sizeof(buf), f)) > 0;)
+    data.append(buf, n);
+
+  fclose(f);
+  return data;
+}
+#endif
+
+bool language_uit::parse_parallel(unsigned int jobs)
+{
+#ifdef _WIN32
+  error("Parallel parsing is not supported on Windows, sorry");
+  return true;
+#else
+  // Files are typechecked in the order of the file map, as in typecheck()
+  for(const auto &arg : _cmdline.args)
+    if(add_file(arg) == nullptr)
+      return true;
+
+  std::vector<language_filet *> files;
+  for(auto &it : language_files.filemap)
+    files.push_back(&it.second);
+
+  // Each worker sends back its symbols, and what it printed, in temporary
+  // files. Those are read into memory and closed as soon as the worker is
+  // reaped, so no more than two per running worker are ever open; the
+  // output is replayed in file order.
+  struct workert
   {
-    if(get_ui() == ui_message_handlert::PLAIN)
-      std::cerr << "PARSING ERROR" << std::endl;
+    unsigned int nr;
+    FILE *symbols;
+    FILE *output;
+  };
+
+  std::vector<std::string> symbols(files.size());
+  std::vector<std::string> outputs(files.size());
+  std::vector<int> exit_codes(files.size(), -1);
+  std::map<pid_t, workert> running;
+  unsigned int next = 0;
+  bool failed = false;
+
+  while(next < files.size() || !running.empty())
+  {
+    while(!failed && next < files.size() && running.size() < jobs)
+    {
+      workert w;
+      w.nr = next++;
+      w.symbols = tmpfile();
+      w.output = tmpfile();
+
+      std::cout.flush();
+      std::cerr.flush();
+
+      pid_t pid = (w.symbols && w.output) ? fork() : -1;
+      if(pid == -1)
+      {
+        if(w.symbols != nullptr)
+          fclose(w.symbols);
+        if(w.output != nullptr)
+          fclose(w.output);
+
+        error("Fork failed, giving up");
+        failed = true;
+        break;
+      }
+
+      if(pid)
+      {
+        running.emplace(pid, w);
+        continue;
+      }
+
+      // Child process
+      dup2(fileno(w.output), STDOUT_FILENO);
+      dup2(fileno(w.output), STDERR_FILENO);
+
+      int code = 1;
+      try
+      {
+        language_filet &lf = *files[w.nr];
+        contextt unit;
+
+        status("Parsing", lf.filename);
+        bool parse_failed =
+          lf.language->parse(lf.filename, *get_message_handler());
+        if(!parse_failed)
+          lf.get_modules();
+
+        if(parse_failed)
+        {
+          if(get_ui() == ui_message_handlert::PLAIN)
+            std::cerr << "PARSING ERROR" << std::endl;
+        }
+        else if(!lf.modules.empty())
+          error("--parallel-frontend can't be used with modules", lf.filename);
+        else if(lf.language->typecheck(unit, "", *get_message_handler()))
+        {
+          if(get_ui() == ui_message_handlert::PLAIN)
+            std::cerr << "CONVERSION ERROR" << std::endl;
+        }
+        else
+        {
+          std::ostringstream out;
+          irep_serializationt::ireps_containert irepc;
+          symbol_serializationt symbolconverter(irepc);
+
+          write_long(out, unit.size());
+          unit.foreach_operand_in_order(
+            [&symbolconverter, &out](const symbolt &s) {
+              symbolconverter.convert(s, out);
+            });
+
+          const std::string &data = out.str();
+          if(fwrite(data.data(), 1, data.size(), w.symbols) == data.size())
+            code = 0;
+          fflush(w.symbols);
+        }
+      }
+      catch(...)
+      {
+        code = 1;
+      }
+
+      std::cout.flush();
+      std::cerr.flush();
+      _exit(code);
+    }
+
+    if(running.empty())
+      break;
+
+    int wstatus;
+    pid_t pid = waitpid(-1, &wstatus, 0);
+    if(pid == -1)
+    {
+      if(errno == EINTR)
+        continue;
+      break;
+    }
+
+    auto it = running.find(pid);
+    if(it == running.end())
+      continue;
+
+    const workert &w = it->second;
+    int code = WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : 1;
+    exit_codes[w.nr] = code;
+    outputs[w.nr] = read_and_close(w.output);
+    symbols[w.nr] = read_and_close(w.symbols);
+    failed |= code != 0;
+    running.erase(it);
+  }
 
-    return true;
+  // Only if waitpid itself failed; nothing more can be learnt from these
+  for(auto &it : running)
+  {
+    fclose(it.second.symbols);
+    fclose(it.second.output);
+    failed = true;
+  }
+
+  // Replay what finished, in order, up to the first failure, as parse()
+  // would have printed it
+  unsigned int parsed = 0;
+  for(; parsed < files.size() && exit_codes[parsed] != -1; parsed++)
+  {
+    std::cout << outputs[parsed] << std::flush;
+    if(exit_codes[parsed] != 0)
+      break;
   }
 
-  lf.get_modules();
+  if(failed || parsed < files.size())
+    return true;
+
+  status("Converting");
 
+  for(unsigned int i = 0; i < files.size(); i++)
+  {
+    std::istringstream in(symbols[i]);
+    irep_serializationt::ireps_containert irepc;
+    irep_serializationt irepconverter(irepc);
+    symbol_serializationt symbolconverter(irepc);
+
+    contextt unit;
+    unsigned int count = irepconverter.read_long(in);
+    for(unsigned int j = 0; j < count; j++)
+    {
+      irept t;
+      symbolconverter.convert(in, t);
+      symbolt symbol;
+      symbol.from_irep(t);
+      unit.add(symbol);
+    }
+
+    if(c_link(context, unit, *get_message_handler(), ""))
+    {
+      if(get_ui() == ui_message_handlert::PLAIN)
+        std::cerr << "CONVERSION ERROR" << std::endl;
+
+      return true;
+    }
+  }
+
+  typechecked = true;
   return false;
+#endif
 }
 
 bool language_uit::typecheck()
 {
+  if(typechecked)
+    return false;
+
   status("Converting");
 
   language_files.set_message_handler(message_handler);
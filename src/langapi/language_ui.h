@@ -49,6 +49,15 @@ public:
 
 protected:
   const cmdlinet &_cmdline;
+
+  /** Set when parse() has typechecked and linked the files already */
+  bool typechecked;
+
+  language_filet *add_file(const std::string &filename);
+
+  /** Parses and typechecks every file in a process of its own, at most jobs
+   *  at a time, then links them in the same order as typecheck() would. */
+  bool parse_parallel(unsigned int jobs);
 };
 
 #endif
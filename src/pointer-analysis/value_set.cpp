@@ -133,11 +133,23 @@ bool value_sett::make_union(const value_sett::valuest &new_values, bool keepnew)
 {
   bool result = false;
 
-  // Iterate over all new values; if they're in the current value set, merge
+  // Entries the two sets still share hold nothing new. Collect the others
+  // first, as merging them modifies this set.
+  std::vector<const valuest::value_type *> differing;
+  values.diff(
+    new_values,
+    [&differing](
+      const valuest::value_type *, const valuest::value_type *new_value) {
+      if(new_value != nullptr)
+        differing.push_back(new_value);
+    });
+
+  // Iterate over the new values; if they're in the current value set, merge
   // them. If not, only merge it in if keepnew is true.
-  for(const auto &new_value : new_values)
+  for(const valuest::value_type *new_value_p : differing)
   {
-    valuest::iterator it2 = values.find(new_value.first);
+    const valuest::value_type &new_value = *new_value_p;
+    valuest::const_iterator it2 = values.find(new_value.first);
 
     // If the new variable isnt in this' set,
     if(it2 == values.end())
@@ -158,12 +170,14 @@ bool value_sett::make_union(const value_sett::valuest &new_values, bool keepnew)
       continue;
     }
 
-    // The variable was in this' set, merge the values.
-    entryt &e = it2->second;
-    const entryt &new_e = new_value.second;
-
-    if(make_union(e.object_map, new_e.object_map))
+    // The variable was in this' set, merge the values. Only write to it if
+    // that adds something, so as not to unshare it needlessly.
+    object_mapt merged = it2->second.object_map;
+    if(make_union(merged, new_value.second.object_map))
+    {
+      values[new_value.first].object_map.swap(merged);
       result = true;
+    }
   }
 
   return result;
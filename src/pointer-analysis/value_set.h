@@ -15,6 +15,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <util/mp_arith.h>
 #include <util/namespace.h>
 #include <util/numbering.h>
+#include <util/persistent_map.h>
 #include <util/type_byte_size.h>
 
 /** Code for tracking "value sets" across assignments in ESBMC.
@@ -252,8 +253,10 @@ public:
 
   /** Type of the value-set containing structure. A hash map mapping variables
    *  to an entryt, storing the value set of objects a variable might point
-   *  at. */
-  typedef std::unordered_map<irep_idt, entryt, irep_id_hash> valuest;
+   *  at. It's persistent: copying a value set for a branch shares all the
+   *  entries until they're written to, and merging it back only visits the
+   *  entries that changed. */
+  typedef persistent_mapt<irep_idt, entryt, irep_id_hash> valuest;
 
   /** Get the natural alignment unit of a reference to e. I don't know a more
    *  appropriate term, but if we were to have an offset into e, then what is
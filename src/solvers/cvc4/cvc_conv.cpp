@@ -94,7 +94,6 @@ expr2tc cvc_convt::get_array_elem(
   smt_astt tmpast = mk_smt_bv(BigInt(index), mk_bv_sort(orig_w));
   auto const *tmpa = to_solver_smt_ast<cvc_smt_ast>(tmpast);
   CVC4::Expr e = em.mkExpr(CVC4::kind::SELECT, carray->a, tmpa->a);
-  delete tmpast;
 
   return get_by_ast(subtype, new_ast(e, convert_sort(subtype)));
 }
@@ -228,12 +228,12 @@ public:
 
   inline array_ast *new_ast(smt_sortt _s)
   {
-    return new array_ast(this, ctx, _s);
+    return new(ctx) array_ast(this, ctx, _s);
   }
 
   inline array_ast *new_ast(smt_sortt _s, const std::vector<smt_astt> &_a)
   {
-    return new array_ast(this, ctx, _s, _a);
+    return new(ctx) array_ast(this, ctx, _s, _a);
   }
 
   void push_array_ctx() override;
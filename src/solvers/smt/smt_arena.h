@@ -0,0 +1,116 @@
+#ifndef SOLVERS_SMT_SMT_ARENA_H_
+#define SOLVERS_SMT_SMT_ARENA_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/** Bump allocator backing the ASTs of one smt_convt.
+ *  Memory is never given back one object at a time: mark() records the top of
+ *  the arena, and release() frees everything allocated since that mark in
+ *  one go. Running destructors is left to the owner. */
+class smt_arenat
+{
+public:
+  struct markt
+  {
+    size_t chunks;
+    size_t used;
+  };
+
+  explicit smt_arenat(size_t _chunk_size = 64 * 1024)
+    : chunk_size(_chunk_size), used(0), reserved(0), peak_reserved(0)
+  {
+  }
+
+  smt_arenat(const smt_arenat &) = delete;
+  smt_arenat &operator=(const smt_arenat &) = delete;
+
+  void *allocate(size_t size)
+  {
+    const size_t align = alignof(std::max_align_t);
+    size = (size + align - 1) & ~(align - 1);
+
+    if(chunks.empty() || used + size > chunks.back().size)
+      new_chunk(size);
+
+    void *p = chunks.back().data.get() + used;
+    used += size;
+    return p;
+  }
+
+  markt mark() const
+  {
+    return markt{chunks.size(), used};
+  }
+
+  void release(const markt &m)
+  {
+    while(chunks.size() > m.chunks)
+    {
+      reserved -= chunks.back().size;
+
+      // Hang on to one chunk, pushing and popping would churn otherwise
+      if(!spare && chunks.back().size == chunk_size)
+        spare = std::move(chunks.back().data);
+
+      chunks.pop_back();
+    }
+
+    used = m.used;
+  }
+
+  void clear()
+  {
+    release(markt{0, 0});
+  }
+
+  size_t num_chunks() const
+  {
+    return chunks.size();
+  }
+
+  size_t reserved_bytes() const
+  {
+    return reserved;
+  }
+
+  size_t peak_reserved_bytes() const
+  {
+    return peak_reserved;
+  }
+
+protected:
+  struct chunkt
+  {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+
+  void new_chunk(size_t size)
+  {
+    chunkt c;
+    c.size = std::max(size, chunk_size);
+    if(spare && c.size == chunk_size)
+      c.data = std::move(spare);
+    else
+      c.data.reset(new char[c.size]);
+
+    chunks.push_back(std::move(c));
+    used = 0;
+
+    reserved += chunks.back().size;
+    peak_reserved = std::max(peak_reserved, reserved);
+  }
+
+  size_t chunk_size;
+  std::vector<chunkt> chunks;
+  std::unique_ptr<char[]> spare;
+  /** Bytes handed out from the last chunk */
+  size_t used;
+  size_t reserved;
+  size_t peak_reserved;
+};
+
+#endif /* SOLVERS_SMT_SMT_ARENA_H_ */
@@ -1,6 +1,7 @@
 #ifndef SOLVERS_SMT_SMT_AST_H_
 #define SOLVERS_SMT_SMT_AST_H_
 
+#include <cstdlib>
 #include <solvers/smt/smt_sort.h>
 #include <util/irep2_expr.h>
 
@@ -39,6 +40,19 @@ public:
   smt_ast(smt_convt *ctx, smt_sortt s);
   virtual ~smt_ast() = default;
 
+  /** ASTs are allocated from their context's arena, so every allocation is
+   *  written as new (ctx) foo_ast(ctx, ...). The memory goes back in bulk when
+   *  the context level that made them is popped. */
+  static void *operator new(size_t size, smt_convt *ctx);
+  static void operator delete(void *p, smt_convt *ctx);
+  /** ASTs are never deleted one by one. This can't be deleted outright, as
+   *  the virtual destructor needs it, so it aborts instead of silently
+   *  leaking. */
+  static void operator delete(void *)
+  {
+    abort();
+  }
+
   // "this" is the true operand.
   virtual smt_astt ite(smt_convt *ctx, smt_astt cond, smt_astt falseop) const;
 
@@ -100,6 +100,11 @@ smt_convt::smt_convt(bool intmode, const namespacet &_ns)
     type2tc(new array_type2t(addr_space_type, expr2tc(), true));
 
   addr_space_data.emplace_back();
+  addr_space_last_obj.push_back(0);
+
+  // esbmc_parseoptionst rejects anything else
+  ordered_memspace =
+    config.options.get_option("memspace-encoding") == "ordered";
 
   machine_int = type2tc(new signedbv_type2t(config.ansi_c.int_width));
   machine_uint = type2tc(new unsignedbv_type2t(config.ansi_c.int_width));
@@ -135,10 +140,25 @@ void smt_convt::set_fp_conv(fp_convt *iface)
 
 void smt_convt::delete_all_asts()
 {
-  // Erase all the remaining asts in the live ast vector.
+  // Destroy all the remaining asts in the live ast vector, then hand their
+  // memory back in one go.
   for(auto *ast : live_asts)
-    delete ast;
+    ast->~smt_ast();
   live_asts.clear();
+  live_asts_sizes.clear();
+
+  ast_arena.clear();
+  ast_arena_marks.clear();
+}
+
+std::string smt_convt::ast_arena_stats() const
+{
+  std::ostringstream str;
+  str << "Solver AST arena: " << ast_arena.reserved_bytes() << " bytes in "
+      << ast_arena.num_chunks() << " chunks (peak "
+      << ast_arena.peak_reserved_bytes() << " bytes), " << live_asts.size()
+      << " live ASTs";
+  return str.str();
 }
 
 void smt_convt::smt_post_init()
@@ -175,11 +195,13 @@ void smt_convt::push_ctx()
   array_api->push_array_ctx();
 
   addr_space_data.push_back(addr_space_data.back());
+  addr_space_last_obj.push_back(addr_space_last_obj.back());
   addr_space_sym_num.push_back(addr_space_sym_num.back());
   pointer_logic.push_back(pointer_logic.back());
   renumber_map.push_back(renumber_map.back());
 
   live_asts_sizes.push_back(live_asts.size());
+  ast_arena_marks.push_back(ast_arena.mark());
 
   ctx_level++;
 }
@@ -193,23 +215,40 @@ void smt_convt::pop_ctx()
   pointer_logic.pop_back();
   addr_space_sym_num.pop_back();
   addr_space_data.pop_back();
+  addr_space_last_obj.pop_back();
   renumber_map.pop_back();
 
   ctx_level--;
 
-  // Go through all the asts created since the last push and delete them.
+  // Go through all the asts created since the last push and destroy them.
 
   for(unsigned int idx = live_asts_sizes.back(); idx < live_asts.size(); idx++)
-    delete live_asts[idx];
+    live_asts[idx]->~smt_ast();
 
-  // And reset the storage back to that point.
+  // And reset the storage back to that point, freeing the whole level.
   live_asts.resize(live_asts_sizes.back());
   live_asts_sizes.pop_back();
+  ast_arena.release(ast_arena_marks.back());
+  ast_arena_marks.pop_back();
 
   array_api->pop_array_ctx();
   tuple_api->pop_tuple_ctx();
 }
 
+smt_convt::resultt smt_convt::dec_solve_assuming(const ast_vec &assumptions)
+{
+  push_ctx();
+  for(auto const &a : assumptions)
+    assert_ast(a);
+
+  return dec_solve();
+}
+
+void smt_convt::end_assumptions()
+{
+  pop_ctx();
+}
+
 smt_astt smt_convt::invert_ast(smt_astt a)
 {
   assert(a->sort->id == SMT_SORT_BOOL);
@@ -8,6 +8,7 @@
 #include <cstdint>
 #include <solvers/prop/literal.h>
 #include <solvers/prop/pointer_logic.h>
+#include <solvers/smt/smt_arena.h>
 #include <util/irep2_utils.h>
 #include <util/message.h>
 #include <util/namespace.h>
@@ -139,7 +140,7 @@ public:
   smt_astt
   new_solver_ast(typename the_solver_ast::solver_ast_type ast, smt_sortt sort)
   {
-    return new the_solver_ast(this, ast, sort);
+    return new(this) the_solver_ast(this, ast, sort);
   }
 
   /** Primary constructor. After construction, smt_post_init must be called
@@ -245,6 +246,18 @@ public:
    *  @return Result code of the call to the solver. */
   virtual resultt dec_solve() = 0;
 
+  /** Solve the formula with the given sub-formula assumed true, for this
+   *  query only. The model, if any, can be read until end_assumptions() is
+   *  called. By default this pushes a context and asserts the assumptions
+   *  into it; solvers that can assume natively don't need to grow and
+   *  shrink the assertion stack for every query.
+   *  @return Result code of the call to the solver. */
+  virtual resultt dec_solve_assuming(const ast_vec &assumptions);
+  /** Forget the assumptions of the last call to dec_solve_assuming. With
+   *  the default push/pop, backends whose pop_ctx doesn't retract
+   *  assertions keep them; see run_multi_property. */
+  virtual void end_assumptions();
+
   void pre_solve();
 
   /** Get the satisfying assignment using the type.
@@ -653,7 +666,8 @@ public:
   std::string get_cur_addrspace_ident();
   /** Create and assert address space constraints on the given object ID
    *  number. Essentially, this asserts that all the objects to date don't
-   *  overlap with /this/ one. */
+   *  overlap with /this/ one; with --memspace-encoding ordered, by placing it
+   *  above the previously allocated object instead. */
   void finalize_pointer_chain(unsigned int obj_num);
 
   /** Typecast data to bools */
@@ -754,6 +768,9 @@ public:
 
   void delete_all_asts();
 
+  /** Summary of the AST arena's memory use, for --memstats. */
+  std::string ast_arena_stats() const;
+
   /** @} */
 
   // Types
@@ -846,18 +863,29 @@ public:
    *  the nubmer of bytes allocated. In a list to support pushing and
    *  popping. */
   std::list<std::map<unsigned, unsigned>> addr_space_data;
+  /** Whether address space constraints order objects by allocation, rather
+   *  than keeping each one apart from every other. */
+  bool ordered_memspace;
+  /** Object number of the most recently allocated object, which the next one
+   *  is placed above in the ordered encoding. In a list to support pushing
+   *  and popping. */
+  std::list<unsigned int> addr_space_last_obj;
 
   // XXX - push-pop will break here.
   typedef std::map<std::string, smt_astt> renumber_mapt;
   std::vector<renumber_mapt> renumber_map;
 
   /** Lifetime tracking of smt ast's. When a context is pop'd, all the ASTs
-   *  created in that context are freed. */
+   *  created in that context are destroyed. */
   std::vector<smt_astt> live_asts;
   /** Accounting of live_asts for push/pop. Records the number of pointers
    *  contained when a push occurred. On pop, the live_asts vector is reset
    *  back to that point. */
   std::vector<unsigned int> live_asts_sizes;
+  /** Storage for the ASTs, with the top of the arena at each push. A pop
+   *  frees a whole level at once instead of deleting each AST. */
+  smt_arenat ast_arena;
+  std::vector<smt_arenat::markt> ast_arena_marks;
 
   tuple_iface *tuple_api;
   array_iface *array_api;
@@ -876,4 +904,14 @@ extern inline smt_ast::smt_ast(smt_convt *ctx, smt_sortt s)
   ctx->live_asts.push_back(this);
 }
 
+inline void *smt_ast::operator new(size_t size, smt_convt *ctx)
+{
+  return ctx->ast_arena.allocate(size);
+}
+
+// Only called if a constructor throws; the arena takes the memory back later
+inline void smt_ast::operator delete(void *, smt_convt *)
+{
+}
+
 #endif /* _ESBMC_PROP_SMT_SMT_CONV_H_ */
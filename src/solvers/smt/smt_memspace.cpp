@@ -423,6 +423,22 @@ void smt_convt::finalize_pointer_chain(unsigned int objnum)
   symbol2tc start_i(inttype, start1.str());
   symbol2tc end_i(inttype, end1.str());
 
+  if(ordered_memspace)
+  {
+    // Place this object above the last one allocated. Each object then only
+    // needs one constraint, and the chain keeps all of them apart.
+    unsigned int prev = addr_space_last_obj.back();
+    std::stringstream endprev;
+    endprev << "__ESBMC_ptr_obj_end_" << prev;
+    symbol2tc end_prev(inttype, endprev.str());
+
+    greaterthan2tc gt(start_i, end_prev);
+    assert_expr(gt);
+
+    addr_space_last_obj.back() = objnum;
+    return;
+  }
+
   for(unsigned int j = 0; j < objnum; j++)
   {
     // Obj1 is designed to overlap
@@ -608,6 +624,7 @@ void smt_convt::init_addr_space_array()
 
   addr_space_data.back()[0] = 0;
   addr_space_data.back()[1] = 0;
+  addr_space_last_obj.back() = 0;
 }
 
 void smt_convt::bump_addrspace_array(unsigned int idx, const expr2tc &val)
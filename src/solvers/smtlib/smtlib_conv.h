@@ -269,6 +269,11 @@ public:
   void push_ctx() override;
   void pop_ctx() override;
 
+  resultt dec_solve_assuming(const ast_vec &assumptions) override;
+  void end_assumptions() override;
+  /** Flush what was emitted so far, and parse the reply to a check-sat */
+  resultt read_check_sat();
+
   // Members
   pid_t solver_proc_pid;
   FILE *out_stream;
@@ -298,6 +303,10 @@ public:
 
   symbol_tablet symbol_table;
   std::vector<unsigned long> temp_sym_count;
+  /** Size of the stdio buffer in front of the solver, or output file.
+   *  Formulas go out in large writes, and are only flushed when the solver
+   *  has to answer. */
+  static const size_t output_buffer_size = 1 << 20;
   static const std::string temp_prefix;
 
   /** Mapping of SMT function IDs to their names. XXX, incorrect size. */
@@ -9,6 +9,9 @@
 #include <util/irep2_utils.h>
 #include <util/migrate.h>
 #include <util/std_types.h>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 template <typename T>
 class register_irep_methods;
@@ -35,6 +38,149 @@ std::string pretty_print_func(unsigned int indent, std::string ident, T obj)
   return exprstr;
 }
 
+/******************************* Hash-consing *********************************/
+
+bool esbmct::hash_consing = false;
+
+namespace
+{
+template <class T>
+class hash_cons_tablet
+{
+public:
+  // Keyed by crc. Entries are weak, so that the table doesn't keep nodes
+  // alive, nor make their owners copy them before writing.
+  typedef std::unordered_multimap<size_t, std::weak_ptr<T>> nodest;
+  nodest nodes;
+
+  // Drop the entries of dead nodes once the table grows past this size
+  size_t sweep_size = 1 << 16;
+  unsigned long lookups = 0;
+  unsigned long shared = 0;
+};
+
+template <class T>
+hash_cons_tablet<T> &get_hash_cons_table()
+{
+  static hash_cons_tablet<T> table;
+  return table;
+}
+} // namespace
+
+template <class T>
+std::shared_ptr<T> esbmct::hash_cons(std::shared_ptr<T> &&p)
+{
+  hash_cons_tablet<T> &table = get_hash_cons_table<T>();
+  ++table.lookups;
+
+  size_t crc = p->crc_val != 0 ? p->crc_val : p->do_crc();
+  auto range = table.nodes.equal_range(crc);
+  for(auto it = range.first; it != range.second;)
+  {
+    std::shared_ptr<T> node = it->second.lock();
+    if(node == nullptr)
+    {
+      it = table.nodes.erase(it);
+      continue;
+    }
+
+    if(*node == *p)
+    {
+      ++table.shared;
+      return node;
+    }
+    ++it;
+  }
+
+  if(table.nodes.size() >= table.sweep_size)
+  {
+    for(auto it = table.nodes.begin(); it != table.nodes.end();)
+    {
+      if(it->second.expired())
+        it = table.nodes.erase(it);
+      else
+        ++it;
+    }
+
+    table.sweep_size = std::max(table.sweep_size, 2 * table.nodes.size());
+  }
+
+  table.nodes.emplace(crc, p);
+  p->interned = true;
+  return std::move(p);
+}
+
+template <class T>
+void esbmct::hash_uncons(const std::shared_ptr<T> &p)
+{
+  hash_cons_tablet<T> &table = get_hash_cons_table<T>();
+
+  // Nothing has written to the node since it was interned, so its crc is
+  // still the one it was filed under
+  auto range = table.nodes.equal_range(p->crc_val);
+  for(auto it = range.first; it != range.second; ++it)
+  {
+    if(!it->second.owner_before(p) && !p.owner_before(it->second))
+    {
+      table.nodes.erase(it);
+      break;
+    }
+  }
+
+  p->interned = false;
+}
+
+template std::shared_ptr<type2t>
+esbmct::hash_cons(std::shared_ptr<type2t> &&p);
+template std::shared_ptr<expr2t>
+esbmct::hash_cons(std::shared_ptr<expr2t> &&p);
+template void esbmct::hash_uncons(const std::shared_ptr<type2t> &p);
+template void esbmct::hash_uncons(const std::shared_ptr<expr2t> &p);
+
+namespace
+{
+// Digests are only wanted when hashing states, so they're kept here rather
+// than in every node. Each entry holds a reference to its node: writing to a
+// shared node detaches a copy, so a digested node never changes, nor can
+// its address be reused, while it has an entry.
+const size_t digest_table_limit = 1 << 20;
+
+template <class T>
+state_hasht cached_digest(const T &node)
+{
+  typedef std::pair<std::shared_ptr<const T>, state_hasht> entryt;
+  static std::unordered_map<const T *, entryt> table;
+
+  auto it = table.find(&node);
+  if(it != table.end())
+    return it->second.second;
+
+  state_hash_buildert digest;
+  node.do_digest(digest);
+  state_hasht result = digest.finish();
+
+  // Start afresh rather than keep every node ever digested alive
+  if(table.size() >= digest_table_limit)
+    table.clear();
+
+  table.emplace(&node, entryt(node.shared_from_this(), result));
+  return result;
+}
+} // namespace
+
+std::string esbmct::hash_cons_stats()
+{
+  const hash_cons_tablet<type2t> &types = get_hash_cons_table<type2t>();
+  const hash_cons_tablet<expr2t> &exprs = get_hash_cons_table<expr2t>();
+
+  std::ostringstream str;
+  str << "Hash-consing: " << types.nodes.size() << " types and "
+      << exprs.nodes.size() << " expressions interned, "
+      << types.shared + exprs.shared << " of "
+      << types.lookups + exprs.lookups << " constructions shared";
+  return str.str();
+}
+
 /*************************** Base type2t definitions **************************/
 
 static const char *type_names[] = {"bool",
@@ -63,7 +209,18 @@ std::string get_type_id(const type2t &type)
 }
 
 type2t::type2t(type_ids id)
-  : std::enable_shared_from_this<type2t>(), type_id(id), crc_val(0)
+  : std::enable_shared_from_this<type2t>(),
+    type_id(id),
+    interned(false),
+    crc_val(0)
+{
+}
+
+type2t::type2t(const type2t &ref)
+  : std::enable_shared_from_this<type2t>(),
+    type_id(ref.type_id),
+    interned(false),
+    crc_val(ref.crc_val)
 {
 }
 
@@ -142,6 +299,16 @@ void type2t::hash(crypto_hash &hash) const
   hash.ingest(&tid, sizeof(tid));
 }
 
+state_hasht type2t::digest() const
+{
+  return cached_digest(*this);
+}
+
+void type2t::do_digest(state_hash_buildert &digest) const
+{
+  digest.word(type_id);
+}
+
 unsigned int bool_type2t::get_width() const
 {
   // For the purpose of the byte representating memory model
@@ -305,13 +472,18 @@ auto type2t_traits<Args...>::make_contained(typename Args::result_type... args)
 /*************************** Base expr2t definitions **************************/
 
 expr2t::expr2t(const type2tc &_type, expr_ids id)
-  : std::enable_shared_from_this<expr2t>(), expr_id(id), type(_type), crc_val(0)
+  : std::enable_shared_from_this<expr2t>(),
+    expr_id(id),
+    interned(false),
+    type(_type),
+    crc_val(0)
 {
 }
 
 expr2t::expr2t(const expr2t &ref)
   : std::enable_shared_from_this<expr2t>(),
     expr_id(ref.expr_id),
+    interned(false),
     type(ref.type),
     crc_val(ref.crc_val)
 {
@@ -424,6 +596,17 @@ void expr2t::hash(crypto_hash &hash) const
   type->hash(hash);
 }
 
+state_hasht expr2t::digest() const
+{
+  return cached_digest(*this);
+}
+
+void expr2t::do_digest(state_hash_buildert &digest) const
+{
+  digest.word(expr_id);
+  digest.digest(type->digest());
+}
+
 static const char *expr_names[] = {
   "constant_int",
   "constant_fixedbv",
@@ -650,6 +833,27 @@ std::string symbol_data::get_symbol_name() const
   }
 }
 
+symbol_data::keyt symbol_data::get_symbol_key() const
+{
+  // Only what get_symbol_name() prints for each level is part of the key
+  switch(rlevel)
+  {
+  case level0:
+  case level1_global:
+    return keyt{thename.get_no(), 0, 0, 0, 0, level0};
+  case level1:
+    return keyt{thename.get_no(), level1_num, thread_num, 0, 0, level1};
+  case level2:
+    return keyt{
+      thename.get_no(), level1_num, thread_num, node_num, level2_num, level2};
+  case level2_global:
+    return keyt{thename.get_no(), 0, 0, node_num, level2_num, level2_global};
+  default:
+    std::cerr << "Unrecognized renaming level enum" << std::endl;
+    abort();
+  }
+}
+
 expr2tc constant_string2t::to_array() const
 {
   std::vector<expr2tc> contents;
@@ -1510,6 +1714,126 @@ static inline void do_type_hash(const expr2t::expr_ids &, crypto_hash &)
   // Dummy field crc
 }
 
+// Digests take every field, ids included, and subexpressions by their own
+// (cached) digest, so that digesting a node costs the size of the node.
+
+static inline void do_type_digest(const bool &theval, state_hash_buildert &d)
+{
+  d.word(theval);
+}
+
+static inline void
+do_type_digest(const unsigned int &theval, state_hash_buildert &d)
+{
+  d.word(theval);
+}
+
+static inline void
+do_type_digest(const sideeffect_data::allockind &theval, state_hash_buildert &d)
+{
+  d.word(theval);
+}
+
+static inline void do_type_digest(
+  const symbol_data::renaming_level &theval,
+  state_hash_buildert &d)
+{
+  d.word(theval);
+}
+
+static inline void do_type_digest(const BigInt &theint, state_hash_buildert &d)
+{
+  if(theint.is_zero())
+  {
+    d.word(0);
+    return;
+  }
+
+  std::array<unsigned char, 256> buffer;
+  if(theint.dump(buffer.data(), buffer.size()))
+  {
+    d.word(theint.is_negative());
+    d.bytes(buffer.data(), buffer.size());
+  }
+  else
+  {
+    // Unlike the crc, don't skip the data of huge numbers: take their text
+    std::string str = integer2string(theint, 16);
+    d.bytes(str.data(), str.size());
+  }
+}
+
+static inline void
+do_type_digest(const fixedbvt &theval, state_hash_buildert &d)
+{
+  do_type_digest(BigInt(theval.to_ansi_c_string().c_str()), d);
+}
+
+static inline void
+do_type_digest(const ieee_floatt &theval, state_hash_buildert &d)
+{
+  do_type_digest(theval.pack(), d);
+}
+
+static inline void
+do_type_digest(const std::vector<expr2tc> &theval, state_hash_buildert &d)
+{
+  d.word(theval.size());
+  for(auto const &it : theval)
+    d.digest(it->digest());
+}
+
+static inline void
+do_type_digest(const std::vector<type2tc> &theval, state_hash_buildert &d)
+{
+  d.word(theval.size());
+  for(auto const &it : theval)
+    d.digest(it->digest());
+}
+
+static inline void
+do_type_digest(const std::vector<irep_idt> &theval, state_hash_buildert &d)
+{
+  // Strings are interned, so their numbers identify them within the process
+  d.word(theval.size());
+  for(auto const &it : theval)
+    d.word(it.get_no());
+}
+
+static inline void do_type_digest(const expr2tc &theval, state_hash_buildert &d)
+{
+  if(theval.get() != nullptr)
+    d.digest(theval->digest());
+  else
+    d.digest(state_hasht());
+}
+
+static inline void do_type_digest(const type2tc &theval, state_hash_buildert &d)
+{
+  if(theval.get() != nullptr)
+    d.digest(theval->digest());
+  else
+    d.digest(state_hasht());
+}
+
+static inline void
+do_type_digest(const irep_idt &theval, state_hash_buildert &d)
+{
+  d.word(theval.get_no());
+}
+
+static inline void
+do_type_digest(const type2t::type_ids &i, state_hash_buildert &d)
+{
+  d.word(i);
+}
+
+static inline void
+do_type_digest(const expr2t::expr_ids &i, state_hash_buildert &d)
+{
+  d.word(i);
+}
+
 template <typename T>
 void do_type2string(
   const T &thething,
@@ -1952,6 +2276,20 @@ void esbmct::
   hash_rec(hash); // _includes_ type_id / expr_id
 }
 
+template <
+  class derived,
+  class baseclass,
+  typename traits,
+  typename container,
+  typename enable,
+  typename fields>
+void esbmct::
+  irep_methods2<derived, baseclass, traits, container, enable, fields>::
+    do_digest(state_hash_buildert &digest) const
+{
+  digest_rec(digest); // _includes_ type_id / expr_id
+}
+
 // The, *actual* recursive defs
 
 template <
@@ -2070,6 +2408,24 @@ void esbmct::
   superclass::hash_rec(hash);
 }
 
+template <
+  class derived,
+  class baseclass,
+  typename traits,
+  typename container,
+  typename enable,
+  typename fields>
+void esbmct::
+  irep_methods2<derived, baseclass, traits, container, enable, fields>::
+    digest_rec(state_hash_buildert &digest) const
+{
+  const derived *derived_this = static_cast<const derived *>(this);
+  auto m_ptr = membr_ptr::value;
+  do_type_digest(derived_this->*m_ptr, digest);
+
+  superclass::digest_rec(digest);
+}
+
 template <
   class derived,
   class baseclass,
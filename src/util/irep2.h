@@ -31,6 +31,7 @@
 #include <util/crypto_hash.h>
 #include <util/dstring.h>
 #include <util/irep.h>
+#include <util/state_hash.h>
 #include <vector>
 
 // Ahead of time: a list of all expressions and types, in a preprocessing
@@ -145,6 +146,36 @@ class type2t;
 class expr2t;
 class constant_array2t;
 
+/** Opt-in hash-consing of irep2 nodes, enabled with --hash-cons-irep2.
+ *  Nodes built through the something2tc constructors are looked up in a
+ *  global intern table, so structurally equal ones share a single object and
+ *  usually compare equal by pointer. The table only keeps weak references,
+ *  so a node's sole owner can still write to it in place: detach() takes it
+ *  out of the table first. */
+namespace esbmct
+{
+extern bool hash_consing;
+
+template <class T>
+std::shared_ptr<T> hash_cons(std::shared_ptr<T> &&p);
+
+/** Takes an interned node out of the intern table, before it's written to. */
+template <class T>
+void hash_uncons(const std::shared_ptr<T> &p);
+
+/** Summary of the intern tables, for status output. */
+std::string hash_cons_stats();
+
+template <class T>
+inline std::shared_ptr<T> maybe_hash_cons(std::shared_ptr<T> &&p)
+{
+  if(!hash_consing)
+    return std::move(p);
+
+  return hash_cons(std::move(p));
+}
+} // namespace esbmct
+
 /** Reference counted container for expr2t based classes.
  *  This class extends boost shared_ptr's to contain anything that's a subclass
  *  of expr2t. It provides several ways of accessing the contained pointer;
@@ -269,7 +300,13 @@ public:
   void detach()
   {
     if(this->use_count() == 1)
-      return; // No point remunging oneself if we're the only user of the ptr.
+    {
+      // No point remunging oneself if we're the only user of the ptr. The
+      // intern table mustn't hand out a node that changes though.
+      if(std::shared_ptr<T>::get()->interned)
+        esbmct::hash_uncons<T>(*this);
+      return;
+    }
 
     // Assign-operate ourself into containing a fresh copy of the data. This
     // creates a new reference counted object, and assigns it to ourself,
@@ -341,8 +378,8 @@ protected:
    */
   type2t(type_ids id);
 
-  /** Copy constructor */
-  type2t(const type2t &ref) = default;
+  /** Copy constructor. Copies are never interned. */
+  type2t(const type2t &ref);
 
   virtual void foreach_subtype_impl_const(const_subtype_delegate &t) const = 0;
   virtual void foreach_subtype_impl(subtype_delegate &t) = 0;
@@ -465,6 +502,19 @@ public:
    */
   virtual void hash(crypto_hash &hash) const;
 
+  /** 128 bit digest of the whole type, for telling types apart where crc
+   *  collisions can't be tolerated. Computed from the digests of subtypes,
+   *  and cached in a table on the side. The type must be held by a type2tc.
+   *  @see do_digest
+   */
+  state_hasht digest() const;
+
+  /** Feed this type's id and fields, with subtypes as their digests, into
+   *  the builder. Overridden by subclasses.
+   *  @param digest Builder to accumulate data into.
+   */
+  virtual void do_digest(state_hash_buildert &digest) const;
+
   /** Clone method. Self explanatory.
    *  @return New container, containing a duplicate of this object.
    */
@@ -489,6 +539,10 @@ public:
   // XXX XXX XXX this should be const
   type_ids type_id;
 
+  /** Whether the hash-consing intern table refers to this type. Sits in the
+   *  padding after type_id. */
+  mutable bool interned;
+
   mutable size_t crc_val;
 };
 
@@ -667,6 +721,21 @@ public:
    */
   virtual void hash(crypto_hash &hash) const;
 
+  /** 128 bit digest of the whole expression, for telling expressions apart
+   *  where crc collisions can't be tolerated, such as state hashing. Computed
+   *  from the digests of operands, and cached in a table on the side, so
+   *  shared subexpressions are only digested once. The expression must be
+   *  held by an expr2tc.
+   *  @see do_digest
+   */
+  state_hasht digest() const;
+
+  /** Feed this expression's id, type and fields, with operands as their
+   *  digests, into the builder. Overridden by subclasses.
+   *  @param digest Builder to accumulate data into.
+   */
+  virtual void do_digest(state_hash_buildert &digest) const;
+
   /** Fetch a sub-operand.
    *  These can come out of any field that is an expr2tc, or contains them.
    *  No particular numbering order is promised.
@@ -758,6 +827,10 @@ public:
   /** Instance of expr_ids recording tihs exprs type. */
   const expr_ids expr_id;
 
+  /** Whether the hash-consing intern table refers to this expression. Sits
+   *  in the padding after expr_id. */
+  mutable bool interned;
+
   /** Type of this expr. All exprs have a type. */
   type2tc type;
 
@@ -1102,6 +1175,7 @@ public:
   int lt(const base2t &ref) const override;
   size_t do_crc() const override;
   void hash(crypto_hash &hash) const override;
+  void do_digest(state_hash_buildert &digest) const override;
 
 protected:
   // Fetch the type information about the field we are concerned with out
@@ -1119,6 +1193,7 @@ protected:
   int lt_rec(const base2t &ref) const;
   void do_crc_rec() const;
   void hash_rec(crypto_hash &hash) const;
+  void digest_rec(state_hash_buildert &digest) const;
 
   // These methods are specific to expressions rather than types, and are
   // placed here to avoid un-necessary recursion in expr_methods2.
@@ -1201,6 +1276,11 @@ protected:
     (void)hash;
   }
 
+  void digest_rec(state_hash_buildert &digest) const
+  {
+    (void)digest;
+  }
+
   const expr2tc *
   get_sub_expr_rec(unsigned int cur_idx, unsigned int desired) const
   {
@@ -1397,7 +1477,8 @@ public:
 
   // Forward all constructors down to the contained type.
   template <typename... Args>
-  something2tc(Args... args) : base2tc(new contained(args...))
+  something2tc(Args... args)
+    : base2tc(maybe_hash_cons(std::shared_ptr<base>(new contained(args...))))
   {
   }
 
@@ -1440,6 +1521,10 @@ T2 *get_pointer(esbmct::something2tc<T1, T2, T3, T4, T5, T6> const &p)
 
 inline bool operator==(const type2tc &a, const type2tc &b)
 {
+  // Also covers two nil ireps, and hash-consed ones
+  if(a.get() == b.get())
+    return true;
+
   // Handle nil ireps
   if(is_nil_type(a) && is_nil_type(b))
     return true;
@@ -1474,6 +1559,9 @@ inline bool operator>(const type2tc &a, const type2tc &b)
 
 inline bool operator==(const expr2tc &a, const expr2tc &b)
 {
+  if(a.get() == b.get())
+    return true;
+
   if(is_nil_expr(a) && is_nil_expr(b))
     return true;
   if(is_nil_expr(a) || is_nil_expr(b))
@@ -206,6 +206,41 @@ public:
 
   virtual std::string get_symbol_name() const;
 
+  /** Identity of the renamed symbol as plain numbers: two keys are equal
+   *  exactly when the names get_symbol_name() builds are, but making one
+   *  allocates nothing. */
+  struct keyt
+  {
+    unsigned int name;
+    unsigned int level1_num;
+    unsigned int thread_num;
+    unsigned int node_num;
+    unsigned int level2_num;
+    renaming_level rlevel;
+
+    bool operator==(const keyt &ref) const
+    {
+      return name == ref.name && level1_num == ref.level1_num &&
+             thread_num == ref.thread_num && node_num == ref.node_num &&
+             level2_num == ref.level2_num && rlevel == ref.rlevel;
+    }
+  };
+
+  struct key_hash
+  {
+    size_t operator()(const keyt &key) const
+    {
+      size_t h = key.name;
+      h = h * 31 + key.level1_num;
+      h = h * 31 + key.thread_num;
+      h = h * 31 + key.node_num;
+      h = h * 31 + key.level2_num;
+      return h * 8 + key.rlevel;
+    }
+  };
+
+  keyt get_symbol_key() const;
+
   // So: I want to make this private, however then all the templates accessing
   // it can't access it; and the typedef for symbol_expr_methods further down
   // can't access it too, no matter how many friends I add.
@@ -8,6 +8,7 @@ Date: May 2007
 
 \*******************************************************************/
 
+#include <boost/functional/hash.hpp>
 #include <sstream>
 #include <util/irep_serialization.h>
 
@@ -91,22 +92,47 @@ void irep_serializationt::reference_convert(
   const irept &irep,
   std::ostream &out)
 {
-  // Do we have this irep already? Horrible complexity here.
-  unsigned int i;
-  for(i = 0; i < ireps_container.ireps_on_write.size(); i++)
+  // Do we have this irep already?
+  auto res = ireps_container.ireps_on_write.emplace(
+    hashed_irept{irep, content_hash(irep)},
+    ireps_container.ireps_on_write.size());
+  write_long(out, res.first->second);
+  if(!res.second)
+    return;
+
+  write_irep(out, irep);
+}
+
+size_t irep_serializationt::content_hash(const irept &irep)
+{
+  auto cached = ireps_container.irep_hashes.find(irep.data);
+  if(cached != ireps_container.irep_hashes.end())
+    return cached->second.second;
+
+  // Built from the hashes of the operands, in order, so that swapped or
+  // repeated operands don't cancel out
+  irep_id_hash id_hash;
+  size_t h = id_hash(irep.id());
+
+  forall_irep(it, irep.get_sub())
+    boost::hash_combine(h, content_hash(*it));
+
+  forall_named_irep(it, irep.get_named_sub())
   {
-    if(full_eq(ireps_container.ireps_on_write[i], irep))
-    {
-      // Match, at idx i
-      write_long(out, i);
-      return;
-    }
+    boost::hash_combine(h, 'N');
+    boost::hash_combine(h, id_hash(it->first));
+    boost::hash_combine(h, content_hash(it->second));
   }
 
-  i = ireps_container.ireps_on_write.size();
-  ireps_container.ireps_on_write.push_back(irep);
-  write_long(out, i);
-  write_irep(out, irep);
+  forall_named_irep(it, irep.get_comments())
+  {
+    boost::hash_combine(h, 'C');
+    boost::hash_combine(h, id_hash(it->first));
+    boost::hash_combine(h, content_hash(it->second));
+  }
+
+  ireps_container.irep_hashes.emplace(irep.data, std::make_pair(irep, h));
+  return h;
 }
 
 void write_long(std::ostream &out, unsigned u)
@@ -162,9 +188,40 @@ dstring irep_serializationt::read_string(std::istream &in)
   return dstring(&(read_buffer[0]));
 }
 
+dstring irep_serializationt::unescape_string(const char *text)
+{
+  std::string s;
+
+  for(; *text != 0; text++)
+  {
+    if(*text == '\\') // escaped chars
+      text++;
+    s += *text;
+  }
+
+  return dstring(s);
+}
+
 void irep_serializationt::write_string_ref(std::ostream &out, const dstring &s)
 {
   unsigned id = s.get_no();
+
+  if(ireps_container.use_string_table)
+  {
+    auto &pos = ireps_container.string_table_pos;
+    if(id >= pos.size())
+      pos.resize(id + 1, 0);
+
+    if(pos[id] == 0)
+    {
+      ireps_container.string_table.push_back(s);
+      pos[id] = ireps_container.string_table.size();
+    }
+
+    write_long(out, pos[id] - 1);
+    return;
+  }
+
   if(id >= ireps_container.string_map.size())
     ireps_container.string_map.resize(id + 1, false);
 
@@ -182,6 +239,23 @@ irep_idt irep_serializationt::read_string_ref(std::istream &in)
 {
   unsigned id = read_long(in);
 
+  if(ireps_container.use_string_table)
+  {
+    auto &text = ireps_container.string_table_text;
+    if(id >= text.size())
+    {
+      std::cerr << "string reference out of range. " << std::endl;
+      throw 0;
+    }
+
+    auto &rev_map = ireps_container.string_rev_map;
+    if(rev_map.size() < text.size())
+      rev_map.resize(text.size(), std::pair<bool, dstring>(false, dstring()));
+    if(!rev_map[id].first)
+      rev_map[id] = std::pair<bool, dstring>(true, unescape_string(text[id]));
+    return rev_map[id].second;
+  }
+
   if(id >= ireps_container.string_rev_map.size())
     ireps_container.string_rev_map.resize(
       1 + id * 2, std::pair<bool, dstring>(false, dstring()));
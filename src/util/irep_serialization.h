@@ -12,6 +12,7 @@ Date: May 2007
 #define IREP_SERIALIZATION_H_
 
 #include <map>
+#include <unordered_map>
 #include <util/irep.h>
 
 void write_long(std::ostream &, unsigned);
@@ -36,23 +37,26 @@ private:
     }
   };
 
-  struct irep_full_hash
+  // An irep, with the hash of its content computed while writing
+  struct hashed_irept
   {
-    size_t operator()(const irept &i) const
-    {
-      return i.full_hash();
-    }
-    bool operator()(const irept &i1, const irept &i2) const
+    irept irep;
+    size_t hash;
+  };
+
+  struct hashed_irep_hash
+  {
+    size_t operator()(const hashed_irept &i) const
     {
-      return i1.full_hash() < i2.full_hash();
+      return i.hash;
     }
   };
 
-  struct irep_content_eq
+  struct hashed_irep_eq
   {
-    bool operator()(const irept &l, const irept &r) const
+    bool operator()(const hashed_irept &l, const hashed_irept &r) const
     {
-      return full_eq(l, r);
+      return l.hash == r.hash && full_eq(l.irep, r.irep);
     }
   };
 
@@ -63,21 +67,46 @@ public:
     typedef std::map<unsigned, irept> irepts_on_readt;
     irepts_on_readt ireps_on_read;
 
-    typedef std::vector<irept> irepts_on_writet;
+    // Index of every irep written so far, by content
+    typedef std::
+      unordered_map<hashed_irept, unsigned, hashed_irep_hash, hashed_irep_eq>
+        irepts_on_writet;
     irepts_on_writet ireps_on_write;
 
+    // Content hash of every node seen while writing, by node, so that shared
+    // subtrees are hashed once. Holding the irep keeps the node alive, so
+    // its address can't be reused for another.
+    typedef std::unordered_map<const void *, std::pair<irept, size_t>>
+      irep_hashest;
+    irep_hashest irep_hashes;
+
     typedef std::vector<bool> string_mapt;
     string_mapt string_map;
 
     typedef std::vector<std::pair<bool, dstring>> string_rev_mapt;
     string_rev_mapt string_rev_map;
 
+    // With a string table, strings are referred to by their position in it
+    // and never written inline, so that each irep can be read on its own.
+    bool use_string_table = false;
+
+    // On write: the table position of each string, plus one, by number
+    std::vector<unsigned> string_table_pos;
+    std::vector<dstring> string_table;
+
+    // On read: the escaped text of each string, interned on first use
+    std::vector<const char *> string_table_text;
+
     void clear()
     {
       ireps_on_write.clear();
+      irep_hashes.clear();
       ireps_on_read.clear();
       string_map.clear();
       string_rev_map.clear();
+      string_table_pos.clear();
+      string_table.clear();
+      string_table_text.clear();
     }
   };
 
@@ -101,11 +130,15 @@ public:
   static unsigned read_long(std::istream &);
   dstring read_string(std::istream &);
 
+  /** Decodes a string written by write_string, starting at text */
+  static dstring unescape_string(const char *text);
+
 private:
   ireps_containert &ireps_container;
   std::vector<char> read_buffer;
 
   void write_irep(std::ostream &, const irept &irep);
+  size_t content_hash(const irept &irep);
   void read_irep(std::istream &, irept &irep);
 };
 
@@ -0,0 +1,717 @@
+#ifndef UTIL_PERSISTENT_MAP_H_
+#define UTIL_PERSISTENT_MAP_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/** Hash map with structural sharing (a CHAMP hash array mapped trie).
+ *  Copying a map is O(1): the copies share every node, and a node is only
+ *  copied when one of them writes to it while it is still shared. Modifying
+ *  an entry therefore copies the path from the root to it and nothing else.
+ *  diff() walks two maps that derive from each other while skipping
+ *  everything they still share, so merging them costs in proportion to how
+ *  much they diverged, not to their size.
+ *
+ *  The interface follows std::unordered_map, with one difference: find()
+ *  always returns a const_iterator, even on a non-const map, so that reads
+ *  never unshare anything. Entries are written through operator[], insert()
+ *  and the iterators of a non-const begin(), which unshares the whole map. */
+template <
+  class K,
+  class V,
+  class Hash = std::hash<K>,
+  class Eq = std::equal_to<K>>
+class persistent_mapt
+{
+public:
+  typedef K key_type;
+  typedef V mapped_type;
+  typedef std::pair<K, V> value_type;
+
+protected:
+  static const unsigned int bits = 5;
+  /** Past this many bits of hash, keys that still share a node are kept in a
+   *  plain list: a collision node. */
+  static const unsigned int max_shift = 64;
+  static const unsigned int max_depth = max_shift / bits + 2;
+
+  struct nodet;
+  typedef std::shared_ptr<nodet> node_ptrt;
+
+  /** Slots that hold an entry are in datamap, slots that hold a subtree in
+   *  nodemap; both are stored compressed, in slot order. */
+  struct nodet
+  {
+    nodet() : datamap(0), nodemap(0)
+    {
+    }
+
+    uint32_t datamap;
+    uint32_t nodemap;
+    std::vector<value_type> data;
+    std::vector<node_ptrt> nodes;
+  };
+
+  template <bool is_const>
+  class iteratort
+  {
+  public:
+    typedef typename std::conditional<is_const, const nodet *, nodet *>::type
+      node_ptr;
+    typedef typename std::
+      conditional<is_const, const value_type &, value_type &>::type reference;
+    typedef typename std::
+      conditional<is_const, const value_type *, value_type *>::type pointer;
+
+    iteratort() : depth(0)
+    {
+    }
+
+    /** Mutable iterators convert to const ones */
+    template <
+      bool other_const,
+      bool c = is_const,
+      class = typename std::enable_if<c>::type>
+    iteratort(const iteratort<other_const> &ref) : depth(ref.depth)
+    {
+      for(unsigned int i = 0; i < depth; i++)
+        stack[i] = framet{ref.stack[i].node, ref.stack[i].idx};
+    }
+
+    reference operator*() const
+    {
+      assert(depth > 0);
+      const framet &f = stack[depth - 1];
+      return f.node->data[f.idx];
+    }
+
+    pointer operator->() const
+    {
+      return &**this;
+    }
+
+    iteratort &operator++()
+    {
+      assert(depth > 0);
+      stack[depth - 1].idx++;
+      settle();
+      return *this;
+    }
+
+    iteratort operator++(int)
+    {
+      iteratort tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const iteratort &ref) const
+    {
+      if(depth != ref.depth)
+        return false;
+      if(depth == 0)
+        return true;
+      return stack[depth - 1].node == ref.stack[depth - 1].node &&
+             stack[depth - 1].idx == ref.stack[depth - 1].idx;
+    }
+
+    bool operator!=(const iteratort &ref) const
+    {
+      return !(*this == ref);
+    }
+
+  protected:
+    friend class persistent_mapt;
+    template <bool>
+    friend class iteratort;
+
+    /** A node being walked; idx counts its entries first, then subtrees.
+     *  Only the innermost frame points at an entry. */
+    struct framet
+    {
+      node_ptr node;
+      size_t idx;
+    };
+
+    void push(node_ptr node, size_t idx)
+    {
+      assert(depth < max_depth);
+      stack[depth++] = framet{node, idx};
+    }
+
+    /** Move forward to the next entry, if the current frame is past them */
+    void settle()
+    {
+      while(depth > 0)
+      {
+        framet &f = stack[depth - 1];
+        if(f.idx < f.node->data.size())
+          return;
+
+        size_t sub = f.idx - f.node->data.size();
+        if(sub < f.node->nodes.size())
+        {
+          f.idx++;
+          push(f.node->nodes[sub].get(), 0);
+          continue;
+        }
+
+        depth--;
+      }
+    }
+
+    framet stack[max_depth];
+    unsigned int depth;
+  };
+
+public:
+  typedef iteratort<false> iterator;
+  typedef iteratort<true> const_iterator;
+
+  persistent_mapt() : num_entries(0)
+  {
+  }
+
+  size_t size() const
+  {
+    return num_entries;
+  }
+
+  bool empty() const
+  {
+    return num_entries == 0;
+  }
+
+  void clear()
+  {
+    root.reset();
+    num_entries = 0;
+  }
+
+  const_iterator begin() const
+  {
+    const_iterator it;
+    if(root)
+    {
+      it.push(root.get(), 0);
+      it.settle();
+    }
+    return it;
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator();
+  }
+
+  const_iterator cbegin() const
+  {
+    return begin();
+  }
+
+  const_iterator cend() const
+  {
+    return end();
+  }
+
+  /** Iterating to write unshares every node of the map */
+  iterator begin()
+  {
+    iterator it;
+    if(root)
+    {
+      unshare_all(root);
+      it.push(root.get(), 0);
+      it.settle();
+    }
+    return it;
+  }
+
+  iterator end()
+  {
+    return iterator();
+  }
+
+  const_iterator find(const K &key) const
+  {
+    const_iterator it;
+    const nodet *n = root.get();
+    if(n == nullptr)
+      return it;
+
+    uint64_t h = hash_of(key);
+    for(unsigned int shift = 0;; shift += bits)
+    {
+      if(shift >= max_shift)
+      {
+        for(size_t i = 0; i < n->data.size(); i++)
+          if(Eq()(n->data[i].first, key))
+          {
+            it.push(n, i);
+            return it;
+          }
+
+        return const_iterator();
+      }
+
+      uint32_t bit = slot_bit(h, shift);
+      if(n->datamap & bit)
+      {
+        size_t i = index(n->datamap, bit);
+        if(!Eq()(n->data[i].first, key))
+          return const_iterator();
+
+        it.push(n, i);
+        return it;
+      }
+
+      if(!(n->nodemap & bit))
+        return const_iterator();
+
+      // Resume after this subtree once it has been iterated over
+      size_t i = index(n->nodemap, bit);
+      it.push(n, n->data.size() + i + 1);
+      n = n->nodes[i].get();
+    }
+  }
+
+  size_t count(const K &key) const
+  {
+    return find(key) != end();
+  }
+
+  V &operator[](const K &key)
+  {
+    return emplace_key(key).first->second;
+  }
+
+  std::pair<iterator, bool> insert(const value_type &value)
+  {
+    std::pair<iterator, bool> r = emplace_key(value.first);
+    if(r.second)
+      r.first->second = value.second;
+    return r;
+  }
+
+  size_t erase(const K &key)
+  {
+    if(find(key) == end())
+      return 0;
+
+    erase_rec(root, 0, hash_of(key), key);
+    if(--num_entries == 0)
+      root.reset();
+    return 1;
+  }
+
+  /** Report every entry that isn't shared between this map and the other,
+   *  skipping the subtrees the two maps have in common.
+   *  @param f Called with the entries of this map and of the other map for
+   *    each such key; one of them is null if the key is missing there. Keys
+   *    in both can still have equal values, it's up to the caller to check.
+   */
+  template <class F>
+  void diff(const persistent_mapt &other, F f) const
+  {
+    diff_rec(root.get(), other.root.get(), 0, f);
+  }
+
+protected:
+  static uint64_t hash_of(const K &key)
+  {
+    // The hashes of irep_idts are string numbers; spread them out
+    uint64_t h = Hash()(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  static uint32_t slot_bit(uint64_t h, unsigned int shift)
+  {
+    return 1u << ((h >> shift) & 31);
+  }
+
+  /** Position of a slot in the compressed storage of a bitmap */
+  static size_t index(uint32_t map, uint32_t bit)
+  {
+    uint32_t v = map & (bit - 1);
+    v = v - ((v >> 1) & 0x55555555);
+    v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+    return (((v + (v >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+  }
+
+  /** Copy a node if something else still refers to it */
+  static nodet *unshare(node_ptrt &p)
+  {
+    if(!p)
+      p = std::make_shared<nodet>();
+    else if(p.use_count() > 1)
+      p = std::make_shared<nodet>(*p);
+    return p.get();
+  }
+
+  static void unshare_all(node_ptrt &p)
+  {
+    nodet *n = unshare(p);
+    for(auto &sub : n->nodes)
+      unshare_all(sub);
+  }
+
+  /** Find an entry for writing, creating it if missing.
+   *  @return Iterator to the entry, and whether it was created. */
+  std::pair<iterator, bool> emplace_key(const K &key)
+  {
+    iterator it;
+    nodet *n = unshare(root);
+    uint64_t h = hash_of(key);
+
+    for(unsigned int shift = 0;; shift += bits)
+    {
+      if(shift >= max_shift)
+      {
+        for(size_t i = 0; i < n->data.size(); i++)
+          if(Eq()(n->data[i].first, key))
+          {
+            it.push(n, i);
+            return std::make_pair(it, false);
+          }
+
+        n->data.emplace_back(key, V());
+        num_entries++;
+        it.push(n, n->data.size() - 1);
+        return std::make_pair(it, true);
+      }
+
+      uint32_t bit = slot_bit(h, shift);
+      if(n->datamap & bit)
+      {
+        size_t i = index(n->datamap, bit);
+        if(Eq()(n->data[i].first, key))
+        {
+          it.push(n, i);
+          return std::make_pair(it, false);
+        }
+
+        // Two keys in one slot: push the entry down into a new subtree, and
+        // go on to insert the new key there too
+        node_ptrt sub = std::make_shared<nodet>();
+        unsigned int sub_shift = shift + bits;
+        if(sub_shift >= max_shift)
+          sub->data.push_back(std::move(n->data[i]));
+        else
+        {
+          sub->datamap = slot_bit(hash_of(n->data[i].first), sub_shift);
+          sub->data.push_back(std::move(n->data[i]));
+        }
+
+        n->data.erase(n->data.begin() + i);
+        n->datamap &= ~bit;
+
+        size_t j = index(n->nodemap, bit);
+        // Moved in, so that this node is its only owner and descending into
+        // it below doesn't copy it
+        n->nodes.insert(n->nodes.begin() + j, std::move(sub));
+        n->nodemap |= bit;
+      }
+
+      if(n->nodemap & bit)
+      {
+        size_t i = index(n->nodemap, bit);
+        it.push(n, n->data.size() + i + 1);
+        n = unshare(n->nodes[i]);
+        continue;
+      }
+
+      size_t i = index(n->datamap, bit);
+      n->data.insert(n->data.begin() + i, value_type(key, V()));
+      n->datamap |= bit;
+      num_entries++;
+      it.push(n, i);
+      return std::make_pair(it, true);
+    }
+  }
+
+  void erase_rec(node_ptrt &p, unsigned int shift, uint64_t h, const K &key)
+  {
+    nodet *n = unshare(p);
+
+    if(shift >= max_shift)
+    {
+      for(size_t i = 0; i < n->data.size(); i++)
+        if(Eq()(n->data[i].first, key))
+        {
+          n->data.erase(n->data.begin() + i);
+          return;
+        }
+      return;
+    }
+
+    uint32_t bit = slot_bit(h, shift);
+    if(n->datamap & bit)
+    {
+      n->data.erase(n->data.begin() + index(n->datamap, bit));
+      n->datamap &= ~bit;
+      return;
+    }
+
+    assert(n->nodemap & bit);
+    size_t i = index(n->nodemap, bit);
+    erase_rec(n->nodes[i], shift + bits, h, key);
+
+    // Don't leave subtrees of one entry behind
+    nodet *sub = n->nodes[i].get();
+    if(!sub->nodes.empty() || sub->data.size() > 1)
+      return;
+
+    if(sub->data.size() == 1)
+    {
+      size_t j = index(n->datamap, bit);
+      n->data.insert(n->data.begin() + j, std::move(sub->data.front()));
+      n->datamap |= bit;
+    }
+
+    n->nodes.erase(n->nodes.begin() + i);
+    n->nodemap &= ~bit;
+  }
+
+  template <class F>
+  static void for_each_rec(const nodet *n, F &f)
+  {
+    if(n == nullptr)
+      return;
+
+    for(auto const &e : n->data)
+      f(e);
+    for(auto const &sub : n->nodes)
+      for_each_rec(sub.get(), f);
+  }
+
+  /** Diff of a lone entry against a subtree (or entry) in the same slot */
+  template <class F>
+  static void diff_entry(
+    const value_type &e,
+    const nodet *n,
+    const value_type *other,
+    bool e_is_mine,
+    F &f)
+  {
+    bool found = false;
+    auto visit = [&](const value_type &o) {
+      if(Eq()(o.first, e.first))
+      {
+        found = true;
+        e_is_mine ? f(&e, &o) : f(&o, &e);
+      }
+      else
+        e_is_mine ? f(nullptr, &o) : f(&o, nullptr);
+    };
+
+    if(other != nullptr)
+      visit(*other);
+    for_each_rec(n, visit);
+
+    if(!found)
+      e_is_mine ? f(&e, nullptr) : f(nullptr, &e);
+  }
+
+  template <class F>
+  static void
+  diff_rec(const nodet *a, const nodet *b, unsigned int shift, F &f)
+  {
+    if(a == b)
+      return;
+
+    if(a == nullptr || b == nullptr)
+    {
+      auto only_a = [&f](const value_type &e) { f(&e, nullptr); };
+      auto only_b = [&f](const value_type &e) { f(nullptr, &e); };
+      if(a != nullptr)
+        for_each_rec(a, only_a);
+      else
+        for_each_rec(b, only_b);
+      return;
+    }
+
+    if(shift >= max_shift)
+    {
+      for(auto const &e : a->data)
+      {
+        const value_type *match = nullptr;
+        for(auto const &o : b->data)
+          if(Eq()(o.first, e.first))
+            match = &o;
+        f(&e, match);
+      }
+
+      for(auto const &o : b->data)
+      {
+        bool in_a = false;
+        for(auto const &e : a->data)
+          in_a |= Eq()(o.first, e.first);
+        if(!in_a)
+          f(nullptr, &o);
+      }
+      return;
+    }
+
+    uint32_t all = a->datamap | a->nodemap | b->datamap | b->nodemap;
+    for(unsigned int slot = 0; slot < 32; slot++)
+    {
+      uint32_t bit = 1u << slot;
+      if(!(all & bit))
+        continue;
+
+      const value_type *ea = (a->datamap & bit)
+                               ? &a->data[index(a->datamap, bit)]
+                               : nullptr;
+      const value_type *eb = (b->datamap & bit)
+                               ? &b->data[index(b->datamap, bit)]
+                               : nullptr;
+      const nodet *na = (a->nodemap & bit)
+                          ? a->nodes[index(a->nodemap, bit)].get()
+                          : nullptr;
+      const nodet *nb = (b->nodemap & bit)
+                          ? b->nodes[index(b->nodemap, bit)].get()
+                          : nullptr;
+
+      if(ea != nullptr)
+        diff_entry(*ea, nb, eb, true, f);
+      else if(eb != nullptr)
+        diff_entry(*eb, na, nullptr, false, f);
+      else
+        diff_rec(na, nb, shift + bits, f);
+    }
+  }
+
+  node_ptrt root;
+  size_t num_entries;
+};
+
+/** Set counterpart of persistent_mapt, with the same sharing and diff() */
+template <class K, class Hash = std::hash<K>, class Eq = std::equal_to<K>>
+class persistent_sett
+{
+protected:
+  struct presentt
+  {
+  };
+  typedef persistent_mapt<K, presentt, Hash, Eq> mapt;
+
+public:
+  typedef K key_type;
+  typedef K value_type;
+
+  class const_iterator
+  {
+  public:
+    const_iterator() = default;
+
+    explicit const_iterator(typename mapt::const_iterator _it) : it(_it)
+    {
+    }
+
+    const K &operator*() const
+    {
+      return it->first;
+    }
+
+    const K *operator->() const
+    {
+      return &it->first;
+    }
+
+    const_iterator &operator++()
+    {
+      ++it;
+      return *this;
+    }
+
+    bool operator==(const const_iterator &ref) const
+    {
+      return it == ref.it;
+    }
+
+    bool operator!=(const const_iterator &ref) const
+    {
+      return it != ref.it;
+    }
+
+  protected:
+    typename mapt::const_iterator it;
+  };
+  typedef const_iterator iterator;
+
+  size_t size() const
+  {
+    return map.size();
+  }
+
+  bool empty() const
+  {
+    return map.empty();
+  }
+
+  void clear()
+  {
+    map.clear();
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(map.begin());
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator(map.end());
+  }
+
+  const_iterator find(const K &key) const
+  {
+    return const_iterator(map.find(key));
+  }
+
+  size_t count(const K &key) const
+  {
+    return map.count(key);
+  }
+
+  std::pair<const_iterator, bool> insert(const K &key)
+  {
+    auto r = map.insert(typename mapt::value_type(key, presentt()));
+    typename mapt::const_iterator it = r.first;
+    return std::make_pair(const_iterator(it), r.second);
+  }
+
+  size_t erase(const K &key)
+  {
+    return map.erase(key);
+  }
+
+  /** @see persistent_mapt::diff */
+  template <class F>
+  void diff(const persistent_sett &other, F f) const
+  {
+    map.diff(
+      other.map,
+      [&f](
+        const typename mapt::value_type *a,
+        const typename mapt::value_type *b) {
+        f(a ? &a->first : nullptr, b ? &b->first : nullptr);
+      });
+  }
+
+protected:
+  mapt map;
+};
+
+#endif /* UTIL_PERSISTENT_MAP_H_ */
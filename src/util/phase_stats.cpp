@@ -0,0 +1,197 @@
+/*******************************************************************\
+
+Module: Per-phase resource usage
+
+\*******************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <new>
+#include <util/phase_stats.h>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+bool phase_statst::enabled = false;
+std::vector<phase_statst::usaget> phase_statst::phases;
+std::unordered_map<const char *, size_t> phase_statst::phase_by_address;
+std::unordered_map<std::string, size_t> phase_statst::phase_by_name;
+std::map<std::string, uint64_t> phase_statst::counters;
+
+static std::atomic<uint64_t> num_allocations(0);
+
+// Count heap allocations by replacing the global allocation functions; they
+// otherwise behave as the default ones.
+void *operator new(std::size_t size)
+{
+  if(phase_statst::enabled)
+    num_allocations.fetch_add(1, std::memory_order_relaxed);
+
+  if(size == 0)
+    size = 1;
+
+  void *p;
+  while((p = std::malloc(size)) == nullptr)
+  {
+    std::new_handler handler = std::get_new_handler();
+    if(handler == nullptr)
+      throw std::bad_alloc();
+    handler();
+  }
+
+  return p;
+}
+
+void *operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+phase_statst::usaget &phase_statst::phase(const char *name)
+{
+  auto it = phase_by_address.find(name);
+  if(it != phase_by_address.end())
+    return phases[it->second];
+
+  // The first time this name is seen at this address; the same text may
+  // still live elsewhere, in another translation unit
+  auto res = phase_by_name.emplace(name, phases.size());
+  if(res.second)
+  {
+    phases.emplace_back();
+    phases.back().name = name;
+  }
+
+  phase_by_address.emplace(name, res.first->second);
+  return phases[res.first->second];
+}
+
+uint64_t phase_statst::allocations()
+{
+  return num_allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t phase_statst::wall_time_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+uint64_t phase_statst::cpu_time_ns()
+{
+  return (uint64_t)std::clock() * (1000000000 / CLOCKS_PER_SEC);
+}
+
+uint64_t phase_statst::peak_rss_kb()
+{
+#ifndef _WIN32
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  // In bytes, rather than kilobytes
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+#else
+  return 0;
+#endif
+}
+
+static void output_seconds(uint64_t ns, std::ostream &out)
+{
+  out << std::fixed << std::setprecision(6) << (double)ns / 1e9;
+}
+
+void phase_statst::output_json(std::ostream &out)
+{
+  out << "{\n  \"phases\": [";
+
+  bool first = true;
+  for(auto const &p : phases)
+  {
+    out << (first ? "\n" : ",\n");
+    first = false;
+
+    out << "    {\"name\": \"" << p.name << "\", \"calls\": " << p.calls
+        << ", \"wall_time\": ";
+    output_seconds(p.wall_ns, out);
+    out << ", \"cpu_time\": ";
+    output_seconds(p.cpu_ns, out);
+    out << ", \"allocations\": " << p.allocations;
+    if(p.peak_rss_kb != 0)
+      out << ", \"peak_rss_kb\": " << p.peak_rss_kb;
+    out << "}";
+  }
+
+  out << "\n  ],\n  \"counters\": {";
+
+  first = true;
+  for(auto const &c : counters)
+  {
+    out << (first ? "\n" : ",\n");
+    first = false;
+    out << "    \"" << c.first << "\": " << c.second;
+  }
+
+  out << "\n  },\n  \"allocations\": " << allocations()
+      << ",\n  \"peak_rss_kb\": " << peak_rss_kb() << "\n}\n";
+}
+
+phase_timert::phase_timert(const char *_phase, bool _sample_rss)
+  : phase(_phase), running(phase_statst::enabled), sample_rss(_sample_rss)
+{
+  if(!running)
+    return;
+
+  wall_start = phase_statst::wall_time_ns();
+  cpu_start = phase_statst::cpu_time_ns();
+  allocs_start = phase_statst::allocations();
+}
+
+void phase_timert::stop()
+{
+  if(!running)
+    return;
+  running = false;
+
+  phase_statst::usaget &usage = phase_statst::phase(phase);
+  usage.calls++;
+  usage.wall_ns += phase_statst::wall_time_ns() - wall_start;
+  usage.cpu_ns += phase_statst::cpu_time_ns() - cpu_start;
+  usage.allocations += phase_statst::allocations() - allocs_start;
+
+  if(sample_rss)
+  {
+    uint64_t rss = phase_statst::peak_rss_kb();
+    if(rss > usage.peak_rss_kb)
+      usage.peak_rss_kb = rss;
+  }
+}
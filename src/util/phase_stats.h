@@ -0,0 +1,95 @@
+/*******************************************************************\
+
+Module: Per-phase resource usage
+
+\*******************************************************************/
+
+#ifndef CPROVER_UTIL_PHASE_STATS_H
+#define CPROVER_UTIL_PHASE_STATS_H
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/** Wall time, CPU time, heap allocations and peak resident set size of each
+ *  phase of a run, plus event counters, for --profile-json and --memstats.
+ *  Phases may nest, and then the outer phase's figures include the inner
+ *  one's. Nothing is recorded unless enabled. */
+class phase_statst
+{
+public:
+  struct usaget
+  {
+    std::string name;
+    uint64_t calls = 0;
+    uint64_t wall_ns = 0;
+    uint64_t cpu_ns = 0;
+    uint64_t allocations = 0;
+    uint64_t peak_rss_kb = 0;
+  };
+
+  static bool enabled;
+
+  /** Add n to a counter */
+  static void count(const char *counter, uint64_t n = 1)
+  {
+    if(enabled)
+      counters[counter] += n;
+  }
+
+  /** Raise a counter to v, if it is lower */
+  static void maximum(const char *counter, uint64_t v)
+  {
+    if(enabled && counters[counter] < v)
+      counters[counter] = v;
+  }
+
+  /** The figures of a phase, found by the address of its name in constant
+   *  time. The name must be a string literal, or otherwise never freed. */
+  static usaget &phase(const char *name);
+
+  /** Heap allocations made so far, while enabled */
+  static uint64_t allocations();
+  static uint64_t wall_time_ns();
+  static uint64_t cpu_time_ns();
+  static uint64_t peak_rss_kb();
+
+  static void output_json(std::ostream &out);
+
+protected:
+  /** In the order the phases first started */
+  static std::vector<usaget> phases;
+  // Positions in phases, by where the name is and, on first use, by text
+  static std::unordered_map<const char *, size_t> phase_by_address;
+  static std::unordered_map<std::string, size_t> phase_by_name;
+  static std::map<std::string, uint64_t> counters;
+};
+
+/** Charges the resources used during its lifetime to a phase. Sampling the
+ *  resident set size takes a system call, so phases entered very often, such
+ *  as those inside symex, can skip it. */
+class phase_timert
+{
+public:
+  explicit phase_timert(const char *_phase, bool _sample_rss = true);
+
+  ~phase_timert()
+  {
+    stop();
+  }
+
+  void stop();
+
+protected:
+  const char *phase;
+  bool running;
+  bool sample_rss;
+  uint64_t wall_start;
+  uint64_t cpu_start;
+  uint64_t allocs_start;
+};
+
+#endif
@@ -0,0 +1,129 @@
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <util/state_hash.h>
+
+void state_hash_buildert::bytes(const void *data, size_t size)
+{
+  const unsigned char *p = static_cast<const unsigned char *>(data);
+
+  word(size);
+  while(size >= 8)
+  {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    word(v);
+    p += 8;
+    size -= 8;
+  }
+
+  uint64_t v = 0;
+  memcpy(&v, p, size);
+  word(v);
+}
+
+std::string state_hasht::to_string() const
+{
+  std::ostringstream buf;
+  buf << std::hex << std::setfill('0') << std::setw(16) << hi << std::setw(16)
+      << lo;
+  return buf.str();
+}
+
+state_hash_sett::state_hash_sett()
+  : slots(1024),
+    num_entries(0),
+    zero_present(false),
+    lookups(0),
+    probes(0),
+    max_probes(0),
+    hits(0)
+{
+}
+
+size_t state_hash_sett::find_slot(const state_hasht &h) const
+{
+  // The capacity is a power of two; the low word is well mixed already
+  size_t mask = slots.size() - 1;
+  size_t idx = h.lo & mask;
+  uint64_t n = 1;
+
+  while(!is_empty(slots[idx]) && slots[idx] != h)
+  {
+    idx = (idx + 1) & mask;
+    n++;
+  }
+
+  probes += n;
+  if(n > max_probes)
+    max_probes = n;
+
+  return idx;
+}
+
+bool state_hash_sett::contains(const state_hasht &h) const
+{
+  lookups++;
+  bool found = is_empty(h) ? zero_present : !is_empty(slots[find_slot(h)]);
+  if(found)
+    hits++;
+  return found;
+}
+
+bool state_hash_sett::insert(const state_hasht &h)
+{
+  // An insert of a hash already present is a hit as much as a contains
+  lookups++;
+  if(is_empty(h))
+  {
+    if(zero_present)
+    {
+      hits++;
+      return false;
+    }
+    zero_present = true;
+    num_entries++;
+    return true;
+  }
+
+  size_t idx = find_slot(h);
+  if(!is_empty(slots[idx]))
+  {
+    hits++;
+    return false;
+  }
+
+  slots[idx] = h;
+  if(++num_entries * 2 > slots.size())
+    grow();
+  return true;
+}
+
+void state_hash_sett::grow()
+{
+  std::vector<state_hasht> old(slots.size() * 2);
+  old.swap(slots);
+
+  size_t mask = slots.size() - 1;
+  for(auto const &h : old)
+  {
+    if(is_empty(h))
+      continue;
+
+    size_t idx = h.lo & mask;
+    while(!is_empty(slots[idx]))
+      idx = (idx + 1) & mask;
+    slots[idx] = h;
+  }
+}
+
+std::string state_hash_sett::stats() const
+{
+  std::ostringstream str;
+  str << "State hashing: " << num_entries << " states in " << slots.size()
+      << " slots, " << hits << " of " << lookups << " lookups hit, ";
+  str << std::fixed << std::setprecision(2)
+      << (lookups ? double(probes) / lookups : 0.0)
+      << " probes per lookup (max " << max_probes << ")";
+  return str.str();
+}
@@ -0,0 +1,179 @@
+#ifndef _CPROVER_SRC_UTIL_STATE_HASH_H_
+#define _CPROVER_SRC_UTIL_STATE_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** 128 bit non-cryptographic hash of a symbolic execution state, or of an
+ *  expression (see expr2t::digest). State hashes are sums of per-variable
+ *  contributions, so that an assignment updates them in constant time:
+ *  subtract what the variable contributed before, add what it contributes
+ *  now. */
+class state_hasht
+{
+public:
+  state_hasht() : lo(0), hi(0)
+  {
+  }
+
+  state_hasht(uint64_t _lo, uint64_t _hi) : lo(_lo), hi(_hi)
+  {
+  }
+
+  state_hasht &operator+=(const state_hasht &h)
+  {
+    lo += h.lo;
+    hi += h.hi;
+    return *this;
+  }
+
+  state_hasht &operator-=(const state_hasht &h)
+  {
+    lo -= h.lo;
+    hi -= h.hi;
+    return *this;
+  }
+
+  bool is_zero() const
+  {
+    return lo == 0 && hi == 0;
+  }
+
+  bool operator==(const state_hasht &h) const
+  {
+    return lo == h.lo && hi == h.hi;
+  }
+
+  bool operator!=(const state_hasht &h) const
+  {
+    return !(*this == h);
+  }
+
+  bool operator<(const state_hasht &h) const
+  {
+    return hi < h.hi || (hi == h.hi && lo < h.lo);
+  }
+
+  std::string to_string() const;
+
+  uint64_t lo, hi;
+};
+
+/** Computes a state_hasht over a sequence of words, in the manner of xxh3:
+ *  each word goes through a 64x64->128 bit multiply folded back to 64 bits,
+ *  into two lanes that each depend on the whole sequence so far, and the
+ *  lanes get xxh3's avalanche at the end. Not cryptographic, but unlike a
+ *  64 bit crc it leaves accidental collisions out of practical reach. */
+class state_hash_buildert
+{
+public:
+  state_hash_buildert()
+    : lo(0x9e3779b185ebca87ULL), hi(0xc2b2ae3d27d4eb4fULL), count(0)
+  {
+  }
+
+  void word(uint64_t v)
+  {
+    count++;
+    lo = mul_fold(lo ^ v ^ 0x165667b19e3779f9ULL, hi ^ 0x27d4eb2f165667c5ULL);
+    hi = mul_fold(hi ^ rotl(v, 32) ^ 0x85ebca77c2b2ae63ULL, lo + count);
+  }
+
+  void digest(const state_hasht &h)
+  {
+    word(h.lo);
+    word(h.hi);
+  }
+
+  void bytes(const void *data, size_t size);
+
+  /** The hash of the words so far; never the all-zero hash, which callers
+   *  may use as "not computed yet" */
+  state_hasht finish() const
+  {
+    state_hasht h(avalanche(lo + count), avalanche(hi ^ rotl(lo, 17)));
+    if(h.is_zero())
+      h.lo = 1;
+    return h;
+  }
+
+protected:
+  uint64_t lo, hi, count;
+
+  static uint64_t rotl(uint64_t v, unsigned int n)
+  {
+    return (v << n) | (v >> (64 - n));
+  }
+
+  static uint64_t mul_fold(uint64_t a, uint64_t b)
+  {
+#ifdef __SIZEOF_INT128__
+    __uint128_t p = (__uint128_t)a * b;
+    return (uint64_t)p ^ (uint64_t)(p >> 64);
+#else
+    uint64_t a_lo = a & 0xffffffff, a_hi = a >> 32;
+    uint64_t b_lo = b & 0xffffffff, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+    uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    uint64_t lower = (cross << 32) | (lo_lo & 0xffffffff);
+    return lower ^ upper;
+#endif
+  }
+
+  /** xxh3's final avalanche */
+  static uint64_t avalanche(uint64_t h)
+  {
+    h ^= h >> 37;
+    h *= 0x165667919e3779f9ULL;
+    h ^= h >> 32;
+    return h;
+  }
+};
+
+/** Open addressing set of state hashes, with linear probing. Never
+ *  allocates except when growing, which it does past a 50% load. */
+class state_hash_sett
+{
+public:
+  state_hash_sett();
+
+  /** @return True if the hash was already in the set. */
+  bool contains(const state_hasht &h) const;
+  /** @return True if the hash was newly inserted. */
+  bool insert(const state_hasht &h);
+
+  size_t size() const
+  {
+    return num_entries;
+  }
+
+  /** Entries, capacity, lookups and how far they had to probe */
+  std::string stats() const;
+
+protected:
+  size_t find_slot(const state_hasht &h) const;
+  void grow();
+
+  static bool is_empty(const state_hasht &h)
+  {
+    return h.lo == 0 && h.hi == 0;
+  }
+
+  /** Slots; the all-zero hash marks an empty one, see zero_present */
+  std::vector<state_hasht> slots;
+  size_t num_entries;
+  bool zero_present;
+
+  // Statistics, counted by contains() and insert() but not when growing;
+  // mutable, as lookups count too
+  mutable uint64_t lookups;
+  mutable uint64_t probes;
+  mutable uint64_t max_probes;
+  mutable uint64_t hits;
+};
+
+#endif /* _CPROVER_SRC_UTIL_STATE_HASH_H_ */
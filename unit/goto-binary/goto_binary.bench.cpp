@@ -0,0 +1,172 @@
+/*******************************************************************
+ Module: Goto binary loading benchmark
+
+ Compares loading a goto binary in the version 1 format, which is read
+ as a stream and decoded as a whole, with the indexed format, mapped
+ into memory with function bodies decoded either all at once or only
+ from the entry point onwards. Fails unless loading from the entry point
+ decodes the entry point, fewer bodies than loading everything, and the
+ same bodies for those functions.
+
+ Usage: gotobinarybench file.goto [runs] [entry function]
+ \*******************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <goto-programs/goto_program_irep.h>
+#include <goto-programs/read_goto_binary.h>
+#include <goto-programs/write_goto_binary.h>
+#include <iostream>
+#include <langapi/mode.h>
+#include <util/irep2.h>
+#include <util/ui_message.h>
+
+static double time_loads(unsigned runs, const std::function<void()> &load)
+{
+  auto start = std::chrono::steady_clock::now();
+  for(unsigned i = 0; i < runs; i++)
+    load();
+  std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return elapsed.count() / runs;
+}
+
+static unsigned count_bodies(const goto_functionst &functions)
+{
+  unsigned n = 0;
+  for(auto const &it : functions.function_map)
+    n += it.second.body_available;
+  return n;
+}
+
+/** Checks the bodies decoded from the entry point against those decoded all
+ *  at once; true on error */
+static bool check_reachable(
+  const std::string &file,
+  const irep_idt &entry,
+  message_handlert &message_handler)
+{
+  contextt all_ctx, entry_ctx;
+  goto_functionst all, from_entry;
+  read_goto_binary(file, all_ctx, all, message_handler);
+  all.load_all();
+  read_goto_binary(file, entry_ctx, from_entry, message_handler);
+  from_entry.load_reachable(entry);
+
+  auto it = from_entry.function_map.find(entry);
+  if(it == from_entry.function_map.end() || !it->second.body_available)
+  {
+    std::cerr << "No body for " << entry << std::endl;
+    return true;
+  }
+
+  unsigned all_bodies = count_bodies(all);
+  unsigned entry_bodies = count_bodies(from_entry);
+  std::cout << "  bodies decoded: " << all_bodies << " in all, "
+            << entry_bodies << " from " << entry << std::endl;
+  if(entry_bodies >= all_bodies)
+  {
+    std::cerr << "Loading from " << entry << " decoded every body"
+              << std::endl;
+    return true;
+  }
+
+  for(auto const &f : from_entry.function_map)
+  {
+    if(!f.second.body_available)
+      continue;
+
+    irept mine, theirs;
+    convert(f.second.body, mine);
+    convert(all.function_map[f.first].body, theirs);
+    if(mine != theirs)
+    {
+      std::cerr << "Body of " << f.first << " differs" << std::endl;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+int main(int argc, const char **argv)
+{
+  if(argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " file.goto [runs] [entry function]"
+              << std::endl;
+    return 1;
+  }
+
+  unsigned runs = argc > 2 ? atoi(argv[2]) : 10;
+  if(runs == 0)
+    runs = 1;
+
+  // To avoid the static initialization fiasco,
+  type_poolt bees(true);
+  type_pool = bees;
+
+  ui_message_handlert message_handler(ui_message_handlert::PLAIN);
+
+  contextt context;
+  goto_functionst functions;
+  if(read_goto_binary(argv[1], context, functions, message_handler))
+    return 1;
+  functions.load_all();
+
+  std::string entry = argc > 3 ? argv[3] : functions.main_id().as_string();
+
+  // The same program, in both formats, next to the original
+  std::string stream_file = std::string(argv[1]) + ".bench-v1";
+  std::string indexed_file = std::string(argv[1]) + ".bench";
+  {
+    std::ofstream out(stream_file, std::ios::binary);
+    write_goto_binary(out, context, functions, 1);
+  }
+  {
+    std::ofstream out(indexed_file, std::ios::binary);
+    write_goto_binary(out, context, functions);
+  }
+
+  std::cout << "Loading " << argv[1] << ": " << context.size() << " symbols, "
+            << functions.function_map.size() << " functions, " << runs
+            << " runs" << std::endl;
+
+  double stream_ms = time_loads(runs, [&]() {
+    contextt ctx;
+    goto_functionst f;
+    std::ifstream in(stream_file, std::ios::binary);
+    read_goto_binary(in, ctx, f, message_handler);
+  });
+
+  double all_ms = time_loads(runs, [&]() {
+    contextt ctx;
+    goto_functionst f;
+    read_goto_binary(indexed_file, ctx, f, message_handler);
+    f.load_all();
+  });
+
+  double entry_ms = time_loads(runs, [&]() {
+    contextt ctx;
+    goto_functionst f;
+    read_goto_binary(indexed_file, ctx, f, message_handler);
+    f.load_reachable(entry);
+  });
+
+  std::cout << "  version 1, streamed:       " << stream_ms << " ms"
+            << std::endl;
+  std::cout << "  indexed, every body:       " << all_ms << " ms" << std::endl;
+  std::cout << "  indexed, from " << entry << ": " << entry_ms << " ms"
+            << std::endl;
+
+  bool failed = check_reachable(indexed_file, entry, message_handler);
+
+  std::remove(stream_file.c_str());
+  std::remove(indexed_file.c_str());
+  return failed ? 1 : 0;
+}
+
+const mode_table_et mode_table[] = {LANGAPI_HAVE_MODE_END};
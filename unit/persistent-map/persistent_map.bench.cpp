@@ -0,0 +1,82 @@
+/*******************************************************************
+ Module: Persistent map branching benchmark
+
+ Models what symex does to level2 names and value sets at branches: a
+ map of live variables is copied into each branch state, a few entries
+ are written in each, and the states are kept alive until they merge.
+ Reports the time taken and the peak resident set size, which is only
+ meaningful with one kind of map per run.
+
+ Usage: persistentmapbench std|persistent [variables] [branches] [writes]
+ \*******************************************************************/
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sys/resource.h>
+#include <util/persistent_map.h>
+#include <vector>
+
+template <class M>
+static size_t branch(unsigned variables, unsigned branches, unsigned writes)
+{
+  M live;
+  for(unsigned i = 0; i < variables; i++)
+    live[i] = i;
+
+  // Each branch state starts from the state before it, like nested ifs
+  std::vector<M> states;
+  states.reserve(branches);
+  const M *cur = &live;
+  for(unsigned b = 0; b < branches; b++)
+  {
+    states.push_back(*cur);
+    M &state = states.back();
+    for(unsigned w = 0; w < writes; w++)
+      state[(b * 7919 + w * 104729) % variables] = b;
+    cur = &state;
+  }
+
+  size_t sum = 0;
+  for(auto const &state : states)
+    sum += state.size();
+  return sum;
+}
+
+int main(int argc, const char **argv)
+{
+  if(argc < 2 || (strcmp(argv[1], "std") && strcmp(argv[1], "persistent")))
+  {
+    std::cerr << "Usage: " << argv[0]
+              << " std|persistent [variables] [branches] [writes]"
+              << std::endl;
+    return 1;
+  }
+
+  unsigned variables = argc > 2 ? atoi(argv[2]) : 10000;
+  unsigned branches = argc > 3 ? atoi(argv[3]) : 1000;
+  unsigned writes = argc > 4 ? atoi(argv[4]) : 10;
+  if(variables == 0)
+    variables = 1;
+
+  auto start = std::chrono::steady_clock::now();
+  size_t sum;
+  if(!strcmp(argv[1], "std"))
+    sum = branch<std::map<unsigned, unsigned>>(variables, branches, writes);
+  else
+    sum = branch<persistent_mapt<unsigned, unsigned>>(
+      variables, branches, writes);
+  std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  std::cout << argv[1] << ": " << variables << " variables, " << branches
+            << " branches, " << writes << " writes each (" << sum
+            << " entries): " << elapsed.count() << "ms, peak RSS "
+            << usage.ru_maxrss << "KB" << std::endl;
+  return 0;
+}
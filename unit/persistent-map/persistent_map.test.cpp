@@ -0,0 +1,262 @@
+/*******************************************************************
+ Module: Persistent map unit test
+
+ Test Plan:
+   - Random inserts, writes and erases, checked against std::map
+   - Copies left untouched by writes to the original
+   - diff() reporting every key that differs
+   - Keys whose hashes collide completely
+   - persistent_sett
+ \*******************************************************************/
+
+#define BOOST_TEST_MODULE "Persistent Map"
+
+#include <boost/test/included/unit_test.hpp>
+#include <map>
+#include <random>
+#include <set>
+#include <util/persistent_map.h>
+
+namespace
+{
+// Few distinct hashes, so that keys share every bit of them
+struct colliding_hash
+{
+  size_t operator()(unsigned int k) const
+  {
+    return k % 3;
+  }
+};
+
+template <class M>
+void check_same(const M &map, const std::map<unsigned int, unsigned int> &ref)
+{
+  BOOST_REQUIRE_EQUAL(map.size(), ref.size());
+
+  size_t seen = 0;
+  for(auto const &e : map)
+  {
+    auto it = ref.find(e.first);
+    BOOST_REQUIRE(it != ref.end());
+    BOOST_CHECK_EQUAL(e.second, it->second);
+    seen++;
+  }
+  BOOST_CHECK_EQUAL(seen, ref.size());
+
+  for(auto const &e : ref)
+  {
+    auto it = map.find(e.first);
+    BOOST_REQUIRE(it != map.end());
+    BOOST_CHECK_EQUAL(it->second, e.second);
+  }
+}
+
+/** Random operations on a map and on a std::map, with copies of both taken
+ *  along the way, which must not change */
+template <class M>
+void random_ops(unsigned int seed, unsigned int key_range, unsigned int ops)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<unsigned int> key(0, key_range - 1);
+  std::uniform_int_distribution<unsigned int> op(0, 9);
+
+  M map;
+  std::map<unsigned int, unsigned int> ref;
+  std::vector<std::pair<M, std::map<unsigned int, unsigned int>>> copies;
+
+  for(unsigned int i = 0; i < ops; i++)
+  {
+    unsigned int k = key(rng);
+    switch(op(rng))
+    {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+      map[k] = i;
+      ref[k] = i;
+      break;
+    case 4:
+    case 5:
+    {
+      auto res = map.insert(std::make_pair(k, i));
+      BOOST_CHECK_EQUAL(res.second, ref.insert(std::make_pair(k, i)).second);
+      BOOST_CHECK_EQUAL(res.first->second, ref[k]);
+      break;
+    }
+    case 6:
+    case 7:
+      BOOST_CHECK_EQUAL(map.erase(k), ref.erase(k));
+      break;
+    case 8:
+      BOOST_CHECK_EQUAL(map.count(k), ref.count(k));
+      break;
+    case 9:
+      if(copies.size() < 16)
+        copies.emplace_back(map, ref);
+      break;
+    }
+  }
+
+  check_same(map, ref);
+  for(auto const &c : copies)
+    check_same(c.first, c.second);
+}
+} // namespace
+
+// ******************** TESTS ********************
+
+// ** Against std::map
+BOOST_AUTO_TEST_SUITE(against_std_map)
+BOOST_AUTO_TEST_CASE(small_keys)
+{
+  for(unsigned int seed = 0; seed < 20; seed++)
+    random_ops<persistent_mapt<unsigned int, unsigned int>>(seed, 64, 2000);
+}
+
+BOOST_AUTO_TEST_CASE(large_keys)
+{
+  for(unsigned int seed = 0; seed < 5; seed++)
+    random_ops<persistent_mapt<unsigned int, unsigned int>>(
+      seed, 100000, 50000);
+}
+
+BOOST_AUTO_TEST_CASE(colliding_keys)
+{
+  for(unsigned int seed = 0; seed < 20; seed++)
+    random_ops<persistent_mapt<unsigned int, unsigned int, colliding_hash>>(
+      seed, 200, 3000);
+}
+
+BOOST_AUTO_TEST_CASE(erase_everything)
+{
+  persistent_mapt<unsigned int, unsigned int> map;
+  for(unsigned int i = 0; i < 1000; i++)
+    map[i] = i;
+  for(unsigned int i = 0; i < 1000; i++)
+    BOOST_CHECK_EQUAL(map.erase(i), 1);
+  BOOST_CHECK(map.empty());
+  BOOST_CHECK(map.begin() == map.end());
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+// ** diff()
+BOOST_AUTO_TEST_SUITE(diffs)
+template <class M>
+void check_diff(unsigned int seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<unsigned int> key(0, 999);
+
+  M a;
+  std::map<unsigned int, unsigned int> ref_a;
+  for(unsigned int i = 0; i < 500; i++)
+  {
+    unsigned int k = key(rng);
+    a[k] = i;
+    ref_a[k] = i;
+  }
+
+  M b = a;
+  std::map<unsigned int, unsigned int> ref_b = ref_a;
+  for(unsigned int i = 0; i < 50; i++)
+  {
+    unsigned int k = key(rng);
+    if(i % 3 == 0)
+    {
+      b.erase(k);
+      ref_b.erase(k);
+    }
+    else
+    {
+      b[k] = 1000 + i;
+      ref_b[k] = 1000 + i;
+    }
+  }
+
+  std::set<unsigned int> reported;
+  typedef typename M::value_type entryt;
+  a.diff(b, [&](const entryt *x, const entryt *y) {
+    BOOST_REQUIRE(x != nullptr || y != nullptr);
+    unsigned int k = x != nullptr ? x->first : y->first;
+    if(x != nullptr && y != nullptr)
+      BOOST_CHECK_EQUAL(x->first, y->first);
+
+    // Each side is what the map holds for the key, or missing from it
+    BOOST_CHECK_EQUAL(x != nullptr, ref_a.count(k) == 1);
+    BOOST_CHECK_EQUAL(y != nullptr, ref_b.count(k) == 1);
+    if(x != nullptr)
+      BOOST_CHECK_EQUAL(x->second, ref_a[k]);
+    if(y != nullptr)
+      BOOST_CHECK_EQUAL(y->second, ref_b[k]);
+
+    BOOST_CHECK(reported.insert(k).second);
+  });
+
+  // Everything that differs is reported; equal entries may be too
+  for(unsigned int k = 0; k < 1000; k++)
+  {
+    bool in_a = ref_a.count(k), in_b = ref_b.count(k);
+    if(in_a != in_b || (in_a && ref_a[k] != ref_b[k]))
+      BOOST_CHECK(reported.count(k));
+  }
+
+  // Unrelated maps diff too
+  M c;
+  c[0] = 0;
+  unsigned int n = 0;
+  a.diff(c, [&](const entryt *, const entryt *) { n++; });
+  BOOST_CHECK_GE(n, ref_a.size());
+}
+
+BOOST_AUTO_TEST_CASE(shared)
+{
+  for(unsigned int seed = 0; seed < 20; seed++)
+    check_diff<persistent_mapt<unsigned int, unsigned int>>(seed);
+}
+
+BOOST_AUTO_TEST_CASE(colliding)
+{
+  for(unsigned int seed = 0; seed < 20; seed++)
+    check_diff<persistent_mapt<unsigned int, unsigned int, colliding_hash>>(
+      seed);
+}
+
+BOOST_AUTO_TEST_CASE(identical)
+{
+  persistent_mapt<unsigned int, unsigned int> a;
+  for(unsigned int i = 0; i < 1000; i++)
+    a[i] = i;
+
+  persistent_mapt<unsigned int, unsigned int> b = a;
+  unsigned int n = 0;
+  a.diff(b, [&](const void *, const void *) { n++; });
+  BOOST_CHECK_EQUAL(n, 0);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+// ** Sets
+BOOST_AUTO_TEST_SUITE(sets)
+BOOST_AUTO_TEST_CASE(against_std_set)
+{
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<unsigned int> key(0, 499);
+
+  persistent_sett<unsigned int> set;
+  std::set<unsigned int> ref;
+  for(unsigned int i = 0; i < 5000; i++)
+  {
+    unsigned int k = key(rng);
+    if(i % 3 == 0)
+      BOOST_CHECK_EQUAL(set.erase(k), ref.erase(k));
+    else
+      BOOST_CHECK_EQUAL(set.insert(k).second, ref.insert(k).second);
+  }
+
+  BOOST_REQUIRE_EQUAL(set.size(), ref.size());
+  for(unsigned int k : set)
+    BOOST_CHECK(ref.count(k));
+  for(unsigned int k : ref)
+    BOOST_CHECK(set.count(k));
+}
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,153 @@
+/*******************************************************************
+ Module: State hash unit test
+
+ Test Plan:
+   - Hash builder
+   - Insertion and lookup
+   - The all-zero hash
+   - Growth
+   - Statistics
+ \*******************************************************************/
+
+#define BOOST_TEST_MODULE "State Hash"
+
+#include <boost/test/included/unit_test.hpp>
+#include <util/state_hash.h>
+
+namespace
+{
+state_hasht hash_of(uint64_t a, uint64_t b)
+{
+  state_hash_buildert h;
+  h.word(a);
+  h.word(b);
+  return h.finish();
+}
+} // namespace
+
+// ******************** TESTS ********************
+
+// ** Hash builder
+BOOST_AUTO_TEST_SUITE(builder)
+BOOST_AUTO_TEST_CASE(deterministic)
+{
+  BOOST_CHECK(hash_of(1, 2) == hash_of(1, 2));
+}
+
+BOOST_AUTO_TEST_CASE(order_matters)
+{
+  BOOST_CHECK(hash_of(1, 2) != hash_of(2, 1));
+}
+
+BOOST_AUTO_TEST_CASE(length_matters)
+{
+  state_hash_buildert h;
+  h.word(0);
+  BOOST_CHECK(h.finish() != hash_of(0, 0));
+}
+
+BOOST_AUTO_TEST_CASE(never_zero)
+{
+  BOOST_CHECK(!state_hash_buildert().finish().is_zero());
+  for(uint64_t i = 0; i < 1000; i++)
+    BOOST_CHECK(!hash_of(i, 0).is_zero());
+}
+
+BOOST_AUTO_TEST_CASE(bytes_padding)
+{
+  state_hash_buildert a, b;
+  a.bytes("abc", 3);
+  b.bytes("abc\0", 4);
+  BOOST_CHECK(a.finish() != b.finish());
+}
+
+BOOST_AUTO_TEST_CASE(sum_is_order_independent)
+{
+  state_hasht x, y;
+  x += hash_of(1, 2);
+  x += hash_of(3, 4);
+  y += hash_of(3, 4);
+  y += hash_of(1, 2);
+  BOOST_CHECK(x == y);
+
+  x -= hash_of(3, 4);
+  BOOST_CHECK(x == hash_of(1, 2));
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+// ** Set
+BOOST_AUTO_TEST_SUITE(set)
+BOOST_AUTO_TEST_CASE(insert_and_contains)
+{
+  state_hash_sett s;
+  BOOST_CHECK(!s.contains(hash_of(1, 1)));
+  BOOST_CHECK(s.insert(hash_of(1, 1)));
+  BOOST_CHECK(s.contains(hash_of(1, 1)));
+  BOOST_CHECK(!s.contains(hash_of(1, 2)));
+  BOOST_CHECK_EQUAL(s.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(duplicate_insert)
+{
+  state_hash_sett s;
+  BOOST_CHECK(s.insert(hash_of(1, 1)));
+  BOOST_CHECK(!s.insert(hash_of(1, 1)));
+  BOOST_CHECK_EQUAL(s.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(zero_hash)
+{
+  // The all-zero hash marks empty slots, so it is tracked on the side
+  state_hash_sett s;
+  BOOST_CHECK(!s.contains(state_hasht()));
+  BOOST_CHECK(s.insert(state_hasht()));
+  BOOST_CHECK(s.contains(state_hasht()));
+  BOOST_CHECK(!s.insert(state_hasht()));
+  BOOST_CHECK_EQUAL(s.size(), 1);
+  BOOST_CHECK(!s.contains(hash_of(0, 0)));
+}
+
+BOOST_AUTO_TEST_CASE(same_low_word)
+{
+  // Hashes that land in the same slot have to probe past each other
+  state_hash_sett s;
+  for(uint64_t i = 0; i < 100; i++)
+    BOOST_CHECK(s.insert(state_hasht(42, i)));
+  for(uint64_t i = 0; i < 100; i++)
+    BOOST_CHECK(s.contains(state_hasht(42, i)));
+  BOOST_CHECK(!s.contains(state_hasht(42, 100)));
+  BOOST_CHECK(s.insert(state_hasht(0, 1)));
+  BOOST_CHECK(!s.contains(state_hasht()));
+}
+
+BOOST_AUTO_TEST_CASE(growth)
+{
+  // Well past the initial capacity, so the set grows several times
+  const uint64_t n = 10000;
+  state_hash_sett s;
+  for(uint64_t i = 0; i < n; i++)
+    BOOST_CHECK(s.insert(hash_of(i, 0)));
+  BOOST_CHECK(s.insert(state_hasht()));
+  BOOST_CHECK_EQUAL(s.size(), n + 1);
+
+  for(uint64_t i = 0; i < n; i++)
+  {
+    BOOST_CHECK(s.contains(hash_of(i, 0)));
+    BOOST_CHECK(!s.contains(hash_of(i, 1)));
+  }
+  BOOST_CHECK(s.contains(state_hasht()));
+}
+
+BOOST_AUTO_TEST_CASE(stats_count_hits)
+{
+  // Growing must not count as lookups, and inserts of known states are hits
+  state_hash_sett s;
+  for(uint64_t i = 0; i < 2000; i++)
+    s.insert(hash_of(i, 0));
+  s.insert(hash_of(0, 0));
+  s.contains(hash_of(1, 0));
+  s.contains(hash_of(1, 1));
+
+  BOOST_CHECK(s.stats().find(" 2 of 2003 lookups hit") != std::string::npos);
+}
+BOOST_AUTO_TEST_SUITE_END()